@@ -27,4 +27,4 @@ project "game"
 
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
 
-    links { "rnCommon", "rnRHI", "rnRHID3D12", "rnApplication", "rnRenderGraph", "rnAsset", "rnData", "rnRender", "imgui", "dxgi", "WinPixEventRuntime" }
\ No newline at end of file
+    links { "rnCommon", "rnRHI", "rnRHID3D12", "rnApplication", "rnRenderGraph", "rnAsset", "lz4", "zstd", "rnData", "rnRender", "imgui", "dxgi", "WinPixEventRuntime" }
\ No newline at end of file
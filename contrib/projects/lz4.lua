@@ -0,0 +1,30 @@
+project "lz4"
+    kind "StaticLib"
+    language "C"
+
+    externaldownloadurl "https://github.com/lz4/lz4/archive/refs/tags/v1.10.0.zip"
+    externaldownloadname "lz4-1.10.0.zip"
+    externaldownloadtype "Zip"
+
+    flags {
+        "MultiProcessorCompile"
+    }
+
+    local source_dir = "%{wks.location}/../../downloads/lz4/lz4-1.10.0/lib"
+
+    RN_LZ4_INCLUDES = {
+        source_dir
+    }
+
+    files {
+        source_dir .. "/lz4.c",
+        source_dir .. "/lz4hc.c",
+        source_dir .. "/lz4.h",
+        source_dir .. "/lz4hc.h"
+    }
+
+    includedirs {
+        source_dir
+    }
+
+    targetdir "%{wks.location}/%{cfg.buildcfg}/"
@@ -0,0 +1,39 @@
+project "zstd"
+    kind "StaticLib"
+    language "C"
+
+    externaldownloadurl "https://github.com/facebook/zstd/archive/refs/tags/v1.5.6.zip"
+    externaldownloadname "zstd-1.5.6.zip"
+    externaldownloadtype "Zip"
+
+    flags {
+        "MultiProcessorCompile"
+    }
+
+    -- The huffman decoder's assembly fast path isn't buildable with MSVC
+    defines {
+        "ZSTD_DISABLE_ASM"
+    }
+
+    local source_dir = "%{wks.location}/../../downloads/zstd/zstd-1.5.6/lib"
+
+    RN_ZSTD_INCLUDES = {
+        source_dir
+    }
+
+    files {
+        source_dir .. "/common/*.c",
+        source_dir .. "/common/*.h",
+        source_dir .. "/compress/*.c",
+        source_dir .. "/compress/*.h",
+        source_dir .. "/decompress/*.c",
+        source_dir .. "/decompress/*.h",
+        source_dir .. "/zstd.h"
+    }
+
+    includedirs {
+        source_dir,
+        source_dir .. "/common"
+    }
+
+    targetdir "%{wks.location}/%{cfg.buildcfg}/"
@@ -0,0 +1,23 @@
+project "registry_bench"
+
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+    flags { "FatalWarnings", "MultiProcessorCompile" }
+
+    files {
+        "src/**.hpp",
+        "src/**.cpp",
+    }
+
+    includedirs(RN_COMMON_INCLUDES)
+    includedirs(RN_ASSET_INCLUDES)
+    includedirs { "../../bench/include" }
+
+    libdirs {
+        "%{wks.location}/%{cfg.buildcfg}"
+    }
+
+    targetdir "%{wks.location}/%{cfg.buildcfg}/"
+
+    links { "rnCommon", "rnAsset", "lz4", "zstd" }
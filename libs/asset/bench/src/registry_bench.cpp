@@ -0,0 +1,411 @@
+#include "common/common.hpp"
+#include "common/memory/memory.hpp"
+#include "common/memory/hash_map.hpp"
+#include "common/memory/string.hpp"
+#include "common/memory/vector.hpp"
+#include "common/task/scheduler.hpp"
+#include "asset/registry.hpp"
+#include "asset/compression.hpp"
+
+#include "asset_gen.hpp"
+#include "luagen/schema.hpp"
+#include "bench/bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+
+using namespace rn;
+using namespace std::literals;
+
+RN_DEFINE_HANDLE(BenchHandle, 0xA0);
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchOptions
+    {
+        uint32_t levels = 4;
+        uint32_t width = 64;
+        uint32_t fanOut = 4;
+        size_t payloadSize = 64 * KILO;
+        uint32_t iterations = 5;
+        asset::schema::AssetCompression compression = asset::schema::AssetCompression::None;
+
+        // When set, the graph also gets written to disk to compare the file backends
+        std::string_view fileDirectory;
+    };
+
+    // Stands in for a builder transcoding its payload, every byte gets touched once
+    struct BenchAsset
+    {
+        uint64_t checksum = 0;
+        size_t size = 0;
+    };
+
+    class BenchAssetBuilder : public asset::Builder<BenchHandle, BenchAsset>
+    {
+    public:
+
+        BenchAsset Build(const asset::AssetBuildDesc& desc) override
+        {
+            uint64_t checksum = 0xCBF29CE484222325;
+            for (uint8_t byte : desc.data)
+            {
+                checksum = (checksum ^ byte) * 0x100000001B3;
+            }
+
+            return {
+                .checksum = checksum + desc.dependencies.size(),
+                .size = desc.data.size()
+            };
+        }
+
+        void Destroy(BenchAsset& data) override {}
+        void Finalize() override {}
+        size_t MemoryFootprint(const BenchAsset& data) override { return data.size; }
+    };
+
+    // Level 0 holds the roots. Every asset references fanOut assets of the next level, overlapping with its neighbours'.
+    String BenchIdentifier(uint32_t level, uint32_t idx)
+    {
+        char buffer[64];
+        int length = std::snprintf(buffer, sizeof(buffer), "bench/l%u_%u.bench", level, idx);
+        return { buffer, size_t(length) };
+    }
+
+    struct BenchContent
+    {
+        Vector<String> identifiers = MakeVector<String>(MemoryCategory::Default);
+        Vector<String> roots = MakeVector<String>(MemoryCategory::Default);
+        HashMap<StringHash, Vector<uint8_t>> files = MakeHashMap<StringHash, Vector<uint8_t>>(MemoryCategory::Default);
+        size_t payloadBytes = 0;
+    };
+
+    BenchContent g_content;
+
+    void GenerateContent(const BenchOptions& options)
+    {
+        bench::NoiseGenerator noise;
+        Vector<uint8_t> payload(options.payloadSize);
+
+        for (uint32_t level = 0; level < options.levels; ++level)
+        {
+            for (uint32_t idx = 0; idx < options.width; ++idx)
+            {
+                MemoryScope SCOPE;
+                String identifier = BenchIdentifier(level, idx);
+
+                noise.Fill(payload);
+
+                Vector<String> referencePaths;
+                Vector<asset::schema::AssetReference> references;
+                if (level + 1 < options.levels)
+                {
+                    for (uint32_t referenceIdx = 0; referenceIdx < options.fanOut; ++referenceIdx)
+                    {
+                        referencePaths.push_back(BenchIdentifier(level + 1, (idx * options.fanOut + referenceIdx) % options.width));
+                    }
+
+                    for (const String& referencePath : referencePaths)
+                    {
+                        references.push_back({
+                            .identifierHash = HashString(referencePath),
+                            .extensionHash = HashString(".bench"),
+                            .path = referencePath
+                        });
+                    }
+                }
+
+                asset::CompressedAssetData compressed = asset::CompressAssetData(payload, options.compression);
+                asset::schema::Asset asset = {
+                    .identifier = ".bench",
+                    .references = references,
+                    .compression = compressed.compression,
+                    .contentHash = asset::HashAssetContent(".bench", payload, references),
+                    .chunks = compressed.chunks,
+                    .assetData = compressed.data
+                };
+
+                Vector<uint8_t>& file = g_content.files[HashString(identifier)];
+                file.resize(asset::schema::Asset::SerializedSize(asset));
+                rn::Serialize<asset::schema::Asset>(file, asset);
+
+                if (level == 0)
+                {
+                    g_content.roots.push_back(identifier);
+                }
+
+                g_content.identifiers.push_back(std::move(identifier));
+                g_content.payloadBytes += payload.size();
+            }
+        }
+    }
+
+    bool WriteContent(std::string_view directory)
+    {
+        for (const String& identifier : g_content.identifiers)
+        {
+            std::filesystem::path path = std::filesystem::path(directory) / identifier.c_str();
+            std::filesystem::create_directories(path.parent_path());
+
+            FILE* outFile = nullptr;
+            fopen_s(&outFile, path.string().c_str(), "wb");
+            if (!outFile)
+            {
+                std::fprintf(stderr, "Failed to open file for writing: '%s'\n", path.string().c_str());
+                return false;
+            }
+
+            const Vector<uint8_t>& file = g_content.files[HashString(identifier)];
+            fwrite(file.data(), 1, file.size(), outFile);
+            fclose(outFile);
+        }
+
+        return true;
+    }
+
+    class InMemoryAsset : public asset::MappedAsset
+    {
+    public:
+        InMemoryAsset(Span<const uint8_t> data)
+            : _data(data)
+        {}
+
+        Span<const uint8_t> Ptr() const override { return _data; }
+
+        Span<const uint8_t> _data;
+    };
+
+    // Serves files straight out of the generated content, without copying
+    TrackedUniquePtr<asset::MappedAsset> MapInMemoryAsset(const String& path)
+    {
+        auto it = g_content.files.find(HashString(path));
+        RN_ASSERT(it != g_content.files.end());
+
+        return TrackedUniquePtr<asset::MappedAsset>(TrackedNew<InMemoryAsset>(asset::MemoryCategory::Asset, it->second));
+    }
+
+    struct BenchBackend
+    {
+        const char* name;
+        asset::FnMapAsset onMapAsset;
+    };
+
+    enum class LoadPath
+    {
+        Load,
+        Batch
+    };
+
+    struct BenchResult
+    {
+        Vector<double> totalMs;
+
+        // Per root for individual loads, per batch for batches
+        Vector<double> latencyMs;
+    };
+
+    double Percentile(Vector<double> values, double percentile)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+
+        std::sort(values.begin(), values.end());
+        size_t idx = std::min(values.size() - 1, size_t(percentile * double(values.size())));
+        return values[idx];
+    }
+
+    double ElapsedMs(Clock::time_point start, Clock::time_point end)
+    {
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    BenchResult RunBench(const BenchOptions& options, const char* contentPrefix, asset::FnMapAsset onMapAsset, bool multithreaded, LoadPath loadPath)
+    {
+        BenchResult result;
+        Vector<std::string_view> roots;
+        for (const String& root : g_content.roots)
+        {
+            roots.push_back(root);
+        }
+
+        for (uint32_t iteration = 0; iteration < options.iterations; ++iteration)
+        {
+            BenchAssetBuilder builder;
+
+            // A fresh registry per iteration, so every asset goes through the full load
+            asset::Registry registry({
+                .contentPrefix = contentPrefix,
+                .enableMultithreadedLoad = multithreaded,
+                .onMapAsset = onMapAsset
+            });
+
+            registry.RegisterAssetType<BenchHandle, BenchAsset>({
+                .identifierHash = HashString(".bench"),
+                .initialCapacity = g_content.identifiers.size(),
+                .builder = &builder
+            });
+
+            Vector<BenchHandle> handles;
+            asset::Batch batch = asset::Batch::Invalid;
+
+            Clock::time_point start = Clock::now();
+            if (loadPath == LoadPath::Load)
+            {
+                for (std::string_view root : roots)
+                {
+                    Clock::time_point loadStart = Clock::now();
+                    handles.push_back(registry.Load<BenchHandle>(root));
+                    result.latencyMs.push_back(ElapsedMs(loadStart, Clock::now()));
+                }
+            }
+            else
+            {
+                batch = registry.LoadBatch(roots);
+                registry.WaitForBatch(batch);
+                result.latencyMs.push_back(ElapsedMs(start, Clock::now()));
+            }
+            result.totalMs.push_back(ElapsedMs(start, Clock::now()));
+
+            // Every asset in the graph is reachable from the roots
+            RN_ASSERT(registry.BankStats<BenchHandle>().residentCount == g_content.identifiers.size());
+
+            if (loadPath == LoadPath::Batch)
+            {
+                for (asset::Asset asset : registry.BatchAssets(batch))
+                {
+                    registry.Release(asset);
+                }
+
+                registry.ReleaseBatch(batch);
+            }
+
+            for (BenchHandle handle : handles)
+            {
+                registry.Release(handle);
+            }
+        }
+
+        return result;
+    }
+
+    void PrintResult(const char* backend, bool multithreaded, LoadPath loadPath, const BenchResult& result)
+    {
+        double meanMs = 0.0;
+        for (double ms : result.totalMs)
+        {
+            meanMs += ms;
+        }
+        meanMs /= double(std::max<size_t>(result.totalMs.size(), 1));
+
+        double seconds = meanMs / 1000.0;
+        std::printf("%-12s %-8s %-6s %10.2f %12.0f %10.1f %10.3f %10.3f %10.3f\n",
+            backend,
+            multithreaded ? "mt" : "st",
+            loadPath == LoadPath::Load ? "load" : "batch",
+            meanMs,
+            double(g_content.identifiers.size()) / seconds,
+            double(g_content.payloadBytes) / double(MEGA) / seconds,
+            Percentile(result.latencyMs, 0.5),
+            Percentile(result.latencyMs, 0.99),
+            Percentile(result.latencyMs, 1.0));
+    }
+
+    constexpr const bench::OptionDesc OPTIONS[] = {
+        { "-levels", "N", "Depth of the asset graph (default 4)" },
+        { "-width", "N", "Assets per level, level 0 holds the roots (default 64)" },
+        { "-fanout", "N", "References per asset into the next level (default 4)" },
+        { "-payload", "BYTES", "Payload size per asset (default 65536)" },
+        { "-iterations", "N", "Loads of the whole graph per configuration (default 5)" },
+        { "-compression", "TYPE", "none, lz4 or zstd (default none)" },
+        { "-files", "DIRECTORY", "Also writes the graph to DIRECTORY and compares the file backends against each other" }
+    };
+
+    bool ParseOptions(int argc, char* argv[], BenchOptions& outOptions)
+    {
+        return bench::ParseOptions(argc, argv, [&outOptions](const bench::Option& option)
+        {
+            auto [arg, param, isNumber, value] = option;
+
+            if (arg == "-levels"sv && isNumber && value > 0)            { outOptions.levels = uint32_t(value); }
+            else if (arg == "-width"sv && isNumber && value > 0)        { outOptions.width = uint32_t(value); }
+            else if (arg == "-fanout"sv && isNumber && value > 0)       { outOptions.fanOut = uint32_t(value); }
+            else if (arg == "-payload"sv && isNumber)                   { outOptions.payloadSize = value; }
+            else if (arg == "-iterations"sv && isNumber && value > 0)   { outOptions.iterations = uint32_t(value); }
+            else if (arg == "-compression"sv && param == "none"sv)      { outOptions.compression = asset::schema::AssetCompression::None; }
+            else if (arg == "-compression"sv && param == "lz4"sv)       { outOptions.compression = asset::schema::AssetCompression::LZ4; }
+            else if (arg == "-compression"sv && param == "zstd"sv)      { outOptions.compression = asset::schema::AssetCompression::Zstd; }
+            else if (arg == "-files"sv)                                 { outOptions.fileDirectory = param; }
+            else
+            {
+                return false;
+            }
+
+            return true;
+        });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        bench::PrintUsage("registry_bench", OPTIONS);
+        return 1;
+    }
+
+    // The logger is left uninitialized on purpose, per asset log lines would dominate the measurements
+    InitializeScopedAllocationForThread(16 * MEGA);
+    InitializeTaskScheduler();
+
+    GenerateContent(options);
+    std::printf("%zu assets in %u levels of %u, fan-out %u, %zu byte payloads, %u iterations\n\n",
+        g_content.identifiers.size(),
+        options.levels,
+        options.width,
+        options.fanOut,
+        options.payloadSize,
+        options.iterations);
+
+    Vector<BenchBackend> backends = { { "memory", &MapInMemoryAsset } };
+    String filePrefix;
+    if (!options.fileDirectory.empty())
+    {
+        if (!WriteContent(options.fileDirectory))
+        {
+            return 1;
+        }
+
+        // Only the first iteration reads from disk, unless the OS file cache gets flushed between runs
+        filePrefix = { options.fileDirectory.data(), options.fileDirectory.size() };
+        filePrefix.append("/");
+        backends.push_back({ "mmap", &asset::MapFileAsset });
+        backends.push_back({ "prefetched", &asset::MapFileAssetPrefetched });
+        backends.push_back({ "unbuffered", &asset::ReadFileAsset });
+    }
+
+    std::printf("%-12s %-8s %-6s %10s %12s %10s %10s %10s %10s\n", "backend", "threads", "path", "mean ms", "assets/s", "MiB/s", "p50 ms", "p99 ms", "max ms");
+    for (const BenchBackend& backend : backends)
+    {
+        const char* contentPrefix = backend.onMapAsset == &MapInMemoryAsset ? "" : filePrefix.c_str();
+        for (bool multithreaded : { false, true })
+        {
+            for (LoadPath loadPath : { LoadPath::Load, LoadPath::Batch })
+            {
+                BenchResult result = RunBench(options, contentPrefix, backend.onMapAsset, multithreaded, loadPath);
+                PrintResult(backend.name, multithreaded, loadPath, result);
+            }
+        }
+    }
+
+    g_content = {};
+    TeardownTaskScheduler();
+    TeardownScopedAllocationForThread();
+    return 0;
+}
@@ -12,6 +12,7 @@
 namespace rn::asset
 {
     class Registry;
+    class MappedAsset;
 
     RN_MEMORY_CATEGORY(Asset);
 
@@ -26,6 +27,10 @@ namespace rn::asset
         Span<const uint8_t> data;
         Span<const Asset> dependencies;
         const Registry* registry;
+
+        // Set when data is a view into the asset's mapping rather than a decompressed copy. The mapping stays alive until
+        // Build returns, builders which keep pointing into data afterwards can take ownership by moving it out.
+        TrackedUniquePtr<MappedAsset>* mapping = nullptr;
     };
 
     template <typename HandleType, typename DataType>
@@ -36,6 +41,9 @@ namespace rn::asset
         virtual DataType    Build(const AssetBuildDesc& desc) = 0;
         virtual void        Destroy(DataType& data) = 0;
         virtual void        Finalize() = 0;
+
+        // Bytes counted against the asset type's memory budget
+        virtual size_t      MemoryFootprint(const DataType& data) = 0;
     };
 
     template <typename HandleType, typename DataType>
@@ -43,6 +51,11 @@ namespace rn::asset
     {
         StringHash identifierHash;
         size_t initialCapacity;
+
+        // Needs to outlive the registry, which destroys whatever is still resident through it
         Builder<HandleType, DataType>* builder;
+
+        // Unreferenced assets get evicted once their footprints exceed the budget. 0 means unbounded.
+        size_t memoryBudgetInBytes = 0;
     };
 }
\ No newline at end of file
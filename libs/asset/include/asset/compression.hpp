@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "common/memory/memory.hpp"
+#include "common/memory/span.hpp"
+
+#include "asset_gen.hpp"
+
+namespace rn::asset
+{
+    // Asset payloads are compressed in independent chunks so they can be decompressed in parallel
+    constexpr const size_t COMPRESSION_CHUNK_SIZE = 256 * 1024;
+
+    struct CompressedAssetData
+    {
+        schema::AssetCompression compression = schema::AssetCompression::None;
+        Span<schema::CompressedChunk> chunks;
+        Span<uint8_t> data;
+
+        // Holds the chunks and compressed data, empty when data points at the uncompressed input
+        TrackedUniquePtr<uint8_t> storage;
+    };
+
+    // Falls back to storing data uncompressed if compression fails or doesn't pay off
+    CompressedAssetData CompressAssetData(Span<const uint8_t> data, schema::AssetCompression compression);
+
+    struct DecompressedAssetData
+    {
+        Span<const uint8_t> data;
+
+        // Holds the decompressed data, empty when data points at the asset's uncompressed payload
+        TrackedUniquePtr<uint8_t> storage;
+    };
+
+    // Identifiers with equal content hashes build to the same data, which lets the registry share it between them.
+    // Covers the uncompressed payload, so the hash doesn't depend on the compression settings.
+    schema::ContentHash HashAssetContent(std::string_view extension, Span<const uint8_t> data, Span<const schema::AssetReference> references);
+
+    // Checks the offset table and identifier of a built asset file, without deserializing anything. Rejects files which
+    // aren't assets or were written in an older layout, so they can be skipped before their offsets get followed.
+    bool IsValidAssetFile(Span<const uint8_t> data);
+
+    // Gets the uncompressed payload of an asset. Uncompressed payloads are returned as is, compressed payloads get
+    // decompressed into a heap buffer owned by outData, spread over the task scheduler if multithreaded is set.
+    // Returns false if the payload is corrupt or the buffer couldn't be allocated.
+    bool DecompressAssetData(const schema::Asset& asset, bool multithreaded, DecompressedAssetData& outData);
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "common/memory/span.hpp"
+#include "common/memory/string.hpp"
+#include "common/memory/vector.hpp"
+#include "asset/asset.hpp"
+
+#include <chrono>
+
+namespace rn::asset
+{
+    // Watches a content directory for files being written, added or renamed, for Registry::ReloadChanged to pick up
+    class ContentWatcher
+    {
+    public:
+
+        using Clock = std::chrono::steady_clock;
+
+        // Changes are only reported once a file has gone quiet for settleTime, so half written files don't get loaded
+        ContentWatcher(const char* directory, Clock::duration settleTime = std::chrono::milliseconds(100));
+        ~ContentWatcher();
+
+        bool IsValid() const;
+
+        // Doesn't block. Identifiers are relative to the watched directory and stay valid until the next poll.
+        Span<const std::string_view> PollChanges();
+
+    private:
+
+        struct PlatformState;
+
+        // Paths seen changing, along with the time they last changed at. Only ever holds a handful of files.
+        struct PendingChange
+        {
+            String path;
+            Clock::time_point lastChange;
+        };
+
+        void ReadPlatformChanges();
+        void AddPendingChange(String&& path, Clock::time_point time);
+
+        Clock::duration _settleTime;
+        TrackedUniquePtr<PlatformState> _platform;
+        Vector<PendingChange> _pendingChanges = MakeVector<PendingChange>(MemoryCategory::Asset);
+        Vector<String> _changes = MakeVector<String>(MemoryCategory::Asset);
+        Vector<std::string_view> _changeViews = MakeVector<std::string_view>(MemoryCategory::Asset);
+    };
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "common/memory/span.hpp"
+#include "common/memory/string.hpp"
+#include "asset/registry.hpp"
+
+namespace rn::asset
+{
+    // Manifests describe the full reference closure of every asset in a content directory, so loads can be planned
+    // without mapping a single asset file.
+    // Layout: ManifestHeader, followed by the entries sorted by identifier hash, followed by the closure indices,
+    // followed by the sanitized asset paths.
+    constexpr const uint32_t MANIFEST_MAGIC = 0x464D4E52; // "RNMF"
+    constexpr const uint32_t MANIFEST_VERSION = 1;
+
+    struct ManifestHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t entryCount;
+        uint64_t closureIndexCount;
+        uint64_t pathSizeInBytes;
+    };
+
+    struct ManifestEntry
+    {
+        StringHash identifierHash;
+        StringHash extensionHash;
+        uint64_t fileSizeInBytes;
+        uint64_t dataSizeInBytes;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+
+        // Entry indices of all transitive references, dependencies before their dependents, ending with the entry itself
+        uint32_t closureOffset;
+        uint32_t closureCount;
+    };
+
+    class Manifest
+    {
+    public:
+
+        Manifest(const String& path, FnMapAsset onMapAsset = &MapFileAsset);
+
+        bool                        IsValid() const;
+        const ManifestEntry*        Find(StringHash identifierHash) const;
+        const ManifestEntry&        Entry(uint32_t entryIdx) const;
+        Span<const uint32_t>        Closure(const ManifestEntry& entry) const;
+        std::string_view            Path(const ManifestEntry& entry) const;
+
+    private:
+
+        TrackedUniquePtr<MappedAsset> _mapping;
+        Span<const ManifestEntry> _entries;
+        Span<const uint32_t> _closureIndices;
+        std::string_view _paths;
+    };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "common/memory/span.hpp"
+#include "common/memory/string.hpp"
+#include "asset/registry.hpp"
+
+namespace rn::asset
+{
+    // Pack files bundle many built assets behind a single file mapping.
+    // Layout: PackHeader, followed by a table of contents sorted by identifier hash, followed by page-aligned asset blobs.
+    constexpr const uint32_t PACK_MAGIC = 0x4B504E52; // "RNPK"
+    constexpr const uint32_t PACK_VERSION = 1;
+    constexpr const uint64_t PACK_BLOB_ALIGNMENT = 4096;
+
+    struct PackHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t entryCount;
+        uint64_t blobAlignment;
+    };
+
+    struct PackEntry
+    {
+        StringHash identifierHash;
+        uint64_t offsetInBytes;
+        uint64_t sizeInBytes;
+    };
+
+    class Pack
+    {
+    public:
+
+        Pack(const String& path);
+
+        bool                IsValid() const;
+        Span<const uint8_t> Find(StringHash identifierHash) const;
+
+    private:
+
+        TrackedUniquePtr<MappedAsset> _mapping;
+        Span<const PackEntry> _toc;
+    };
+
+    // Mounted packs serve identifiers relative to their mount prefix, which should match the registry's content prefix.
+    // Assets mapped from a pack are views into the pack's mapping, so packs need to outlive any assets mapped from them.
+    bool MountPack(const String& path, const String& mountPrefix);
+    void UnmountPacks();
+
+    // Resolves assets through the mounted packs' tables of contents, falls back to loose files if no pack contains the asset
+    TrackedUniquePtr<MappedAsset> MapPackedAsset(const String& path);
+}
@@ -3,32 +3,92 @@
 #include "common/common.hpp"
 #include "common/memory/span.hpp"
 #include "asset/asset.hpp"
+#include "asset/telemetry.hpp"
+#include "common/memory/object_pool.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
 
 namespace rn::asset
 {
     class BankBase;
+    class Manifest;
+
+    namespace schema
+    {
+        struct AssetReference;
+    }
 
     enum class LoadFlags : uint32_t
     {
         None = 0x0,
-        Reload = 0x01
+
+        // Reloads the asset and, recursively, all of its references
+        Reload = 0x01,
+
+        // Reloads the asset itself, references are only loaded if they aren't already. Not supported by batches.
+        ReloadShallow = 0x02
     };
     RN_DEFINE_ENUM_CLASS_BITWISE_API(LoadFlags)
 
+    RN_DEFINE_HANDLE(Batch, 0x30)
+
     class MappedAsset
     {
     public:
+        virtual ~MappedAsset() {}
         virtual Span<const uint8_t> Ptr() const = 0;
     };
 
-    using FnMapAsset = MappedAsset*(*)(MemoryScope& scope, const String& path);
-    MappedAsset* MapFileAsset(MemoryScope& scope, const String& path);
+    // Mappings are owned by the registry and may be kept alive across tasks while a batch is being loaded.
+    // Files which can't be mapped return null, which fails the load of the asset.
+    using FnMapAsset = TrackedUniquePtr<MappedAsset>(*)(const String& path);
+    TrackedUniquePtr<MappedAsset> MapFileAsset(const String& path);
+
+    // Maps the file like MapFileAsset, but asks the OS to fault its pages in ahead of first touch
+    TrackedUniquePtr<MappedAsset> MapFileAssetPrefetched(const String& path);
+
+    // Reads the whole file with unbuffered, overlapped I/O into a pooled sector-aligned buffer,
+    // keeping several reads in flight. Avoids page faults on first touch altogether.
+    TrackedUniquePtr<MappedAsset> ReadFileAsset(const String& path);
+
+    struct AssetBankStats
+    {
+        size_t residentCount = 0;
+        size_t residentBytes = 0;
+        size_t budgetBytes = 0;
+        size_t evictionCount = 0;
+        size_t evictedBytes = 0;
+
+        // Resident assets sharing the data of another asset with the same content
+        size_t sharedCount = 0;
+    };
+
+    struct BatchPlan
+    {
+        size_t assetCount = 0;
+        size_t fileSizeInBytes = 0;
+        size_t dataSizeInBytes = 0;
+
+        // Set when all roots were found in the manifest
+        bool complete = false;
+    };
 
     struct RegistryDesc
     {
         const char* contentPrefix;
         bool enableMultithreadedLoad;
         FnMapAsset onMapAsset = &MapFileAsset;
+
+        // Optional, needs to outlive the registry. Lets batches map their whole reference closure up front.
+        const Manifest* manifest = nullptr;
+
+        // Records map, deserialize, dependency wait and build timings of recent asset loads, and per-type totals of all of them
+        bool enableLoadTelemetry = false;
+
+        // Keeps track of the path and references of every loaded asset, which ReloadChanged needs to find dependents
+        bool enableHotReload = false;
     };
 
     class Registry
@@ -41,23 +101,105 @@ namespace rn::asset
         template <typename HandleType, typename DataType>
         void RegisterAssetType(const AssetTypeDesc<HandleType, DataType>& desc);
 
+        // Every load, including loads of batch roots, hands out a reference to the asset which needs to be released.
+        // Unreferenced assets stay resident until their bank exceeds its memory budget, least recently released first.
         template <typename HandleType>
         HandleType Load(std::string_view identifier, LoadFlags flags = LoadFlags::None);
 
+        template <typename HandleType>
+        void Release(HandleType handle);
+        void Release(Asset asset);
+
+        // Evicts all unreferenced assets, regardless of budgets
+        void EvictUnreferenced();
+
+        template <typename HandleType>
+        AssetBankStats BankStats() const;
+
+        // Loads the union of the reference closures of all provided identifiers as a single unit of work.
+        // Files are mapped in parallel and assets are built in dependency order, one wave at a time.
+        // Batches need to be released before the registry is destroyed.
+        Batch               LoadBatch(Span<const std::string_view> identifiers, LoadFlags flags = LoadFlags::None);
+
+        // Sums up the union of the roots' reference closures from the manifest, without touching any asset files
+        BatchPlan           PlanBatch(Span<const std::string_view> identifiers) const;
+        bool                IsBatchComplete(Batch batch) const;
+        void                WaitForBatch(Batch batch) const;
+        Span<const Asset>   BatchAssets(Batch batch) const;
+        void                ReleaseBatch(Batch batch);
+
         template <typename HandleType, typename DataType>
         const DataType* Resolve(HandleType handle) const;
 
+        // Rebuilds the resident assets among the changed identifiers whose content actually changed, followed by everything
+        // which references them, dependencies first. Handles stay the same. Returns the number of rebuilt assets.
+        size_t              ReloadChanged(Span<const std::string_view> identifiers);
+
+        // Null unless load telemetry was enabled
+        LoadTelemetry*      Telemetry() const { return _telemetry.get(); }
+
     private:
 
-        Asset LoadInternal(std::string_view identifier, LoadFlags flags);
+        template <typename HandleType, typename DataType>
+        friend class Bank;
+
+        struct BatchState;
+
+        struct HotReloadEntry
+        {
+            String path;
+            BankBase* bank = nullptr;
+            Vector<StringHash> references = MakeVector<StringHash>(MemoryCategory::Asset);
+        };
+
+        Asset       LoadInternal(std::string_view identifier, LoadFlags flags);
+
+        // Loads an identifier which has already been sanitized and hashed, either at runtime or by data_build.
+        // Loads queued as tasks pass the time they were queued at, for telemetry.
+        Asset       LoadResolved(StringHash identifierHash, BankBase* bank, std::string_view path, LoadFlags flags, LoadTelemetry::Clock::time_point queuedAt = {});
+        BankBase*   BankForPath(std::string_view path) const;
+        BankBase*   BankForExtensionHash(StringHash extensionHash) const;
+        BankBase*   BankForAsset(Asset asset) const;
+
+        template <typename HandleType>
+        BankBase*   BankForHandleType() const;
+
+        // Releases the references a load took on its dependencies and leaves its handle NotResident
+        void        FailLoad(BankBase* bank, Asset handle, Span<const Asset> dependencies);
+        bool        AnyLoadFailed(Span<const Asset> assets) const;
+        void        ExecuteBatch(BatchState& batch);
+
+        // Blocks until another asset finished loading, or failed to, after completedLoadCount was read. Nodes whose
+        // wait closes a circle of loads waiting on each other fail instead.
+        void        WaitForDeferredNodes(BatchState& batch, Span<const uint32_t> nodeIndices, uint64_t completedLoadCount);
+        uint64_t    CompletedLoadCount();
+
+        // Called by banks whenever an asset becomes resident or fails to load
+        void        NotifyLoadCompleted();
+        void        RecordHotReloadEntry(StringHash identifierHash, BankBase* bank, std::string_view path, Span<const schema::AssetReference> references);
 
         using BankMap = HashMap<size_t, BankBase*>;
 
         String _contentPrefix;
         bool _enableMultithreadedLoad;
         FnMapAsset _onMapAsset;
+        const Manifest* _manifest;
+        TrackedUniquePtr<LoadTelemetry> _telemetry;
+
+        bool _enableHotReload;
+        std::mutex _hotReloadMutex;
+        HashMap<StringHash, HotReloadEntry> _hotReloadIndex = MakeHashMap<StringHash, HotReloadEntry>(MemoryCategory::Asset);
         BankMap _extensionHashToBank = MakeHashMap<size_t, BankBase*>(MemoryCategory::Asset);
-        BankMap _handleIDToBank = MakeHashMap<size_t, BankBase*>(MemoryCategory::Asset);
+
+        // Maps deferred batch nodes to the reference they're waiting on, to find loads waiting on each other
+        std::mutex _loadWaitMutex;
+        std::condition_variable _loadCompleted;
+        uint64_t _completedLoadCount = 0;
+        HashMap<uint64_t, Asset> _loadWaits = MakeHashMap<uint64_t, Asset>(MemoryCategory::Asset);
+
+        // Indexed by handle salt, so resolving a typed handle is a single load
+        std::array<BankBase*, 256> _banksBySalt = {};
+        ObjectPool<Batch, BatchState*> _batches;
     };
 }
 
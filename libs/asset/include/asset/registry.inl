@@ -1,6 +1,12 @@
 #pragma once
 #include "asset/asset.hpp"
 #include "common/memory/object_pool.hpp"
+#include "common/memory/concurrent_hash_map.hpp"
+#include "common/memory/hash.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <type_traits>
 
 namespace rn::asset
 {
@@ -14,9 +20,35 @@ namespace rn::asset
     {
     public:
 
+        virtual ~BankBase() = default;
+
+        // Handles handed out by FindOrAllocateHandle come with a reference which needs to be released
         virtual std::pair<bool, Asset>  FindOrAllocateHandle(StringHash identifier) = 0;
+        virtual void                    AddReference(Asset handle) = 0;
+        virtual void                    Release(Asset handle) = 0;
         virtual void                    Store(Asset handle, const AssetBuildDesc& desc) = 0;
+
+        // Returns the handle of another asset with the same content, with a reference added for the caller.
+        // Otherwise handle becomes the owner of the content and gets returned as is.
+        virtual Asset                   ShareContent(Asset handle, const LargeHash& contentHash) = 0;
+
+        // Makes handle resolve to a copy of the owner's data instead of building its own. Owners which are still being
+        // loaded hand their data over once they're built, or fail the handle along with them. The handle holds a
+        // reference to the owner until it's evicted or rebuilt.
+        virtual void                    StoreShared(Asset handle, Asset owner) = 0;
+
+        // Marks a load which couldn't be completed. The handle stays NotResident until its last reference is released,
+        // after which the next load tries again. Resident assets keep their previous version.
+        virtual void                    FailLoad(Asset handle) = 0;
+        virtual bool                    LoadFailed(Asset handle) = 0;
+
+        // Used by hot reload, none of these add a reference
+        virtual Asset                   FindResident(StringHash identifier) = 0;
+        virtual LargeHash               ContentHash(Asset handle) = 0;
+        virtual void                    CollectSharers(Asset handle, Vector<StringHash>& outIdentifiers) = 0;
         virtual Residency               AssetResidency(Asset handle) = 0;
+        virtual void                    Evict(size_t targetBytes) = 0;
+        virtual AssetBankStats          Stats() = 0;
     };
 
     template <typename HandleType, typename DataType>
@@ -24,98 +56,633 @@ namespace rn::asset
     {
     public:
 
-        Bank(const AssetTypeDesc<HandleType, DataType>& desc);
+        Bank(const AssetTypeDesc<HandleType, DataType>& desc, Registry* registry);
         ~Bank();
 
         std::pair<bool, Asset>  FindOrAllocateHandle(StringHash identifier) override;
+        void                    AddReference(Asset handle) override;
+        void                    Release(Asset handle) override;
         void                    Store(Asset handle, const AssetBuildDesc& desc) override;
-        void                    Store(Asset handle, DataType&& data, StringHash identifier);
+        void                    Store(Asset handle, DataType&& data);
+        Asset                   ShareContent(Asset handle, const LargeHash& contentHash) override;
+        void                    StoreShared(Asset handle, Asset owner) override;
+        void                    FailLoad(Asset handle) override;
+        bool                    LoadFailed(Asset handle) override;
+
+        Asset                   FindResident(StringHash identifier) override;
+        LargeHash               ContentHash(Asset handle) override;
+        void                    CollectSharers(Asset handle, Vector<StringHash>& outIdentifiers) override;
 
         Residency               AssetResidency(Asset handle) override;
+        void                    Evict(size_t targetBytes) override;
+        AssetBankStats          Stats() override;
 
         const DataType*         Resolve(HandleType handle) const;
         DataType*               Resolve(HandleType handle);
 
 
     private:
+        // Atomic so referencing an asset doesn't need the residency lock, movable so states can be handed to the pool
+        struct RefCount : std::atomic<uint32_t>
+        {
+            using std::atomic<uint32_t>::atomic;
+            RefCount(RefCount&& rhs) : std::atomic<uint32_t>(rhs.load(std::memory_order_relaxed)) {}
+        };
+
+        // Set on the reference count of an unreferenced asset once it's claimed for removal, no references are
+        // handed out after that
+        static constexpr uint32_t EVICTING = 0x80000000;
+
         struct AssetState
         {
             Residency residency = Residency::NotResident;
+            bool loadFailed = false;
+            StringHash identifier = 0;
+            RefCount refCount = 0;
+            uint32_t lruStamp = 0;
+            size_t footprint = 0;
+            Vector<Asset> dependencies = MakeVector<Asset>(MemoryCategory::Asset);
+
+            // Zero unless data_build recorded a content hash
+            LargeHash contentHash = { 0, 0 };
+
+            // Owners keep track of the handles holding copies of their data, which don't destroy them
+            HandleType sharedOwner = HandleType::Invalid;
+            Vector<HandleType> sharers = MakeVector<HandleType>(MemoryCategory::Asset);
+        };
+
+        // Sharing data between identifiers hands out copies, which need to be cheap handles to the same resources
+        static constexpr bool SHARES_CONTENT = std::is_copy_assignable_v<DataType>;
+
+        // Entries go stale when the asset gets referenced again before being evicted
+        struct LRUEntry
+        {
+            HandleType handle;
+            uint32_t lruStamp;
         };
 
+        bool TryAddReference(HandleType handle);
+        bool ClaimForRemoval(AssetState& state);
+        void PushLRU(HandleType handle, AssetState& state);
+        void RemoveAsset(HandleType handle, AssetState& state);
+        void FailLoad(HandleType handle, AssetState& state, Vector<Asset>& outReleasedDependencies);
+        void MarkSharerResident(HandleType handle, AssetState& state);
+        void DetachSharer(HandleType handle, AssetState& state);
+        void CopyToSharers(const AssetState& state, const DataType& data);
+
         Builder<HandleType, DataType>* _builder;
+        Registry* _registry;
         ObjectPool<HandleType, DataType, AssetState> _assets;
 
-        std::shared_mutex _identifierToHandleMutex;
-        HashMap<StringHash, HandleType> _identifierToHandle = MakeHashMap<StringHash, HandleType>(MemoryCategory::Asset);
+        // Lookups don't lock, entries are only ever exchanged for another handle
+        ConcurrentHashMap<HandleType> _identifierToHandle;
+
+        // Guards footprints, content sharing, the LRU list and the removal of assets
+        std::mutex _residencyMutex;
+        HashMap<uint64_t, HandleType> _contentToHandle = MakeHashMap<uint64_t, HandleType>(MemoryCategory::Asset);
+        Vector<LRUEntry> _lru = MakeVector<LRUEntry>(MemoryCategory::Asset);
+        size_t _lruHead = 0;
+        AssetBankStats _stats;
     };
 
 
     template <typename HandleType, typename DataType>
-    Bank<HandleType, DataType>::Bank(const AssetTypeDesc<HandleType, DataType>& desc)
+    Bank<HandleType, DataType>::Bank(const AssetTypeDesc<HandleType, DataType>& desc, Registry* registry)
         : _builder(desc.builder)
+        , _registry(registry)
         , _assets(MemoryCategory::Asset, desc.initialCapacity)
-    {}
+        , _identifierToHandle(MemoryCategory::Asset, desc.initialCapacity)
+    {
+        _stats.budgetBytes = desc.memoryBudgetInBytes;
+    }
+
+    template <typename HandleType, typename DataType>
+    Bank<HandleType, DataType>::~Bank()
+    {
+        // Sharers only hold copies of their owner's data
+        _identifierToHandle.ForEach([this](uint64_t, HandleType handle)
+        {
+            DataType* data = _assets.GetHotPtrMutable(handle);
+            AssetState* state = _assets.GetColdPtrMutable(handle);
+            if (!state)
+            {
+                return;
+            }
+
+            if (state->residency == Residency::Resident && state->sharedOwner == HandleType::Invalid)
+            {
+                _builder->Destroy(*data);
+            }
+
+            _assets.Remove(handle);
+        });
+    }
 
     template <typename HandleType, typename DataType>
     std::pair<bool, Asset> Bank<HandleType, DataType>::FindOrAllocateHandle(StringHash identifier)
     {
-        HandleType handle = HandleType::Invalid;
-        bool allocatedNewAsset = false;
-        typename HashMap<StringHash, HandleType>::iterator it;
+        while (true)
+        {
+            HandleType handle = _identifierToHandle.Find(identifier);
+            if (handle != HandleType::Invalid)
+            {
+                // Fails if the asset is being evicted, in which case the entry gets reset
+                if (TryAddReference(handle))
+                {
+                    return std::make_pair(false, Asset(handle));
+                }
+
+                continue;
+            }
+
+            AssetState newState = {
+                .residency = Residency::NotResident,
+                .identifier = identifier,
+                .refCount = 1
+            };
+
+            HandleType newHandle = _assets.Store(std::move(DataType()), std::move(newState));
+            if (_identifierToHandle.CompareExchange(identifier, handle, newHandle))
+            {
+                return std::make_pair(true, Asset(newHandle));
+            }
+
+            // Another thread allocated the asset first
+            _assets.Remove(newHandle);
+        }
+    }
+
+    template <typename HandleType, typename DataType>
+    bool Bank<HandleType, DataType>::TryAddReference(HandleType handle)
+    {
+        // The pool's shared lock keeps the slot from being reused while the count is updated
+        return _assets.VisitColdMutable(handle, [](AssetState& state)
+        {
+            uint32_t refCount = state.refCount.load(std::memory_order_relaxed);
+            do
+            {
+                if (refCount & EVICTING)
+                {
+                    return false;
+                }
+            }
+            while (!state.refCount.compare_exchange_weak(refCount, refCount + 1, std::memory_order_acquire, std::memory_order_relaxed));
+
+            return true;
+        });
+    }
+
+    template <typename HandleType, typename DataType>
+    bool Bank<HandleType, DataType>::ClaimForRemoval(AssetState& state)
+    {
+        // Fails if the asset got referenced again in the meantime
+        uint32_t expected = 0;
+        return state.refCount.compare_exchange_strong(expected, EVICTING, std::memory_order_acq_rel);
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::AddReference(Asset handle)
+    {
+        bool referenced = _assets.VisitColdMutable(HandleType(handle), [](AssetState& state)
+        {
+            state.refCount.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        });
+
+        RN_ASSERT(referenced);
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::Release(Asset handle)
+    {
+        uint32_t previousCount = 0;
+        bool visited = _assets.VisitColdMutable(HandleType(handle), [&previousCount](AssetState& state)
+        {
+            previousCount = state.refCount.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        });
+
+        if (!visited)
+        {
+            RN_ASSERT(!"Released a stale handle, the asset has been removed already");
+            return;
+        }
+
+        // Released more often than referenced
+        RN_ASSERT(previousCount > 0 && (previousCount & EVICTING) == 0);
+        if (previousCount > 1)
         {
-            std::shared_lock lock(_identifierToHandleMutex);
-            it = _identifierToHandle.find(identifier);
+            return;
         }
 
-        if (it == _identifierToHandle.end())
         {
-            std::unique_lock lock(_identifierToHandleMutex);
+            std::unique_lock lock(_residencyMutex);
+            AssetState* state = _assets.GetColdPtrMutable(HandleType(handle));
 
-            // Double check that no other thread got here first
-            it = _identifierToHandle.find(identifier);
-            if (it == _identifierToHandle.end())
+            // Referenced again, or removed by another release which dropped the new reference first
+            if (!state || state->refCount.load(std::memory_order_acquire) != 0)
             {
-                AssetState newState = {
-                    .residency = Residency::NotResident
-                };
- 
-                handle = _assets.Store(std::move(DataType()), std::move(newState));
-                _identifierToHandle[identifier] = handle;
-                allocatedNewAsset = true;
+                return;
+            }
+
+            // Failed loads aren't kept around, so the next load of the identifier tries again
+            if (state->loadFailed)
+            {
+                if (ClaimForRemoval(*state))
+                {
+                    RemoveAsset(HandleType(handle), *state);
+                }
+                return;
+            }
+
+            if (state->residency != Residency::Resident)
+            {
+                return;
+            }
+
+            PushLRU(HandleType(handle), *state);
+            if (_stats.budgetBytes == 0 || _stats.residentBytes <= _stats.budgetBytes)
+            {
+                return;
             }
         }
-        else
+
+        Evict(_stats.budgetBytes);
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::PushLRU(HandleType handle, AssetState& state)
+    {
+        // Compact the list once most of it has been consumed
+        if (_lruHead > 0 && _lruHead * 2 >= _lru.size())
+        {
+            _lru.erase(_lru.begin(), _lru.begin() + _lruHead);
+            _lruHead = 0;
+        }
+
+        _lru.push_back({
+            .handle = handle,
+            .lruStamp = ++state.lruStamp
+        });
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::RemoveAsset(HandleType handle, AssetState& state)
+    {
+        auto contentIt = _contentToHandle.find(state.contentHash.lower);
+        if (contentIt != _contentToHandle.end() && contentIt->second == handle)
         {
-            handle = it->second;
+            _contentToHandle.erase(contentIt);
         }
 
-        return std::make_pair(allocatedNewAsset, Asset(handle));
+        // Lookups racing with the removal fail to reference the removed handle and retry
+        HandleType expected = handle;
+        _identifierToHandle.CompareExchange(state.identifier, expected, HandleType::Invalid);
+
+        _assets.Remove(handle);
     }
 
     template <typename HandleType, typename DataType>
     void Bank<HandleType, DataType>::Store(Asset handle, const AssetBuildDesc& desc)
     {
-        Store(handle, std::move(_builder->Build(desc)), HashString(desc.identifier));
+        Vector<Asset> releasedDependencies = MakeVector<Asset>(MemoryCategory::Asset);
+        {
+            std::unique_lock lock(_residencyMutex);
+            AssetState* state = _assets.GetColdPtrMutable(HandleType(handle));
+            RN_ASSERT(state);
+
+            // The previous version's dependencies were referenced when it was loaded
+            std::swap(releasedDependencies, state->dependencies);
+            state->dependencies.assign(desc.dependencies.begin(), desc.dependencies.end());
+        }
+
+        Store(handle, std::move(_builder->Build(desc)));
+
+        for (Asset dependency : releasedDependencies)
+        {
+            _registry->Release(dependency);
+        }
     }
 
     template <typename HandleType, typename DataType>
-    void Bank<HandleType, DataType>::Store(Asset handle, DataType&& data, StringHash identifier)
+    void Bank<HandleType, DataType>::Store(Asset handle, DataType&& data)
     {
         HandleType typedHandle = HandleType(handle);
         DataType* storedData = _assets.GetHotPtrMutable(typedHandle);
         AssetState* state = _assets.GetColdPtrMutable(typedHandle);
         RN_ASSERT(storedData);
 
-        _builder->Destroy(*storedData);
-        *storedData = std::move(data);
+        // The previous version is swapped out of the asset and its sharers together, and only destroyed once none of
+        // them hand it out anymore. Shared data belongs to the owner.
+        DataType previousData;
+        bool ownsPreviousData = false;
 
+        bool overBudget = false;
         {
-            std::shared_lock lock(_identifierToHandleMutex);
-            _identifierToHandle[identifier] = typedHandle;
+            std::unique_lock lock(_residencyMutex);
+            ownsPreviousData = state->sharedOwner == HandleType::Invalid;
+            previousData = std::move(*storedData);
+            *storedData = std::move(data);
+
+            DetachSharer(typedHandle, *state);
+            CopyToSharers(*state, *storedData);
+
+            size_t footprint = _builder->MemoryFootprint(*storedData);
+            if (state->residency != Residency::Resident)
+            {
+                ++_stats.residentCount;
+            }
+
+            _stats.residentBytes = _stats.residentBytes - state->footprint + footprint;
+            state->footprint = footprint;
             state->residency = Residency::Resident;
+            state->loadFailed = false;
+
+            // Nobody asked for the asset by the time it finished loading
+            if (state->refCount.load(std::memory_order_acquire) == 0)
+            {
+                PushLRU(typedHandle, *state);
+            }
+
+            overBudget = _stats.budgetBytes > 0 && _stats.residentBytes > _stats.budgetBytes;
+        }
+
+        if (ownsPreviousData)
+        {
+            _builder->Destroy(previousData);
+        }
+
+        _registry->NotifyLoadCompleted();
+        if (overBudget)
+        {
+            Evict(_stats.budgetBytes);
+        }
+    }
+
+    template <typename HandleType, typename DataType>
+    Asset Bank<HandleType, DataType>::ShareContent(Asset handle, const LargeHash& contentHash)
+    {
+        if (contentHash == LargeHash{ 0, 0 })
+        {
+            return handle;
+        }
+
+        HandleType typedHandle = HandleType(handle);
+        std::unique_lock lock(_residencyMutex);
+        AssetState* state = _assets.GetColdPtrMutable(typedHandle);
+        RN_ASSERT(state);
+
+        // Reloaded with different content
+        auto it = _contentToHandle.find(state->contentHash.lower);
+        if (state->contentHash != contentHash && it != _contentToHandle.end() && it->second == typedHandle)
+        {
+            _contentToHandle.erase(it);
+        }
+        state->contentHash = contentHash;
+
+        // Content hashes are still recorded, hot reload compares against them
+        if (!SHARES_CONTENT)
+        {
+            return handle;
+        }
+
+        it = _contentToHandle.find(contentHash.lower);
+        if (it != _contentToHandle.end() && it->second != typedHandle)
+        {
+            AssetState* ownerState = _assets.GetColdPtrMutable(it->second);
+            if (ownerState && ownerState->contentHash == contentHash && ownerState->sharedOwner == HandleType::Invalid && !ownerState->loadFailed)
+            {
+                // Evictions hold the lock from claiming an asset to removing it, so the owner can't be in the middle of one
+                ownerState->refCount.fetch_add(1, std::memory_order_relaxed);
+                return Asset(it->second);
+            }
+        }
+
+        _contentToHandle[contentHash.lower] = typedHandle;
+        return handle;
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::StoreShared(Asset handle, Asset owner)
+    {
+        if constexpr (SHARES_CONTENT)
+        {
+            HandleType typedHandle = HandleType(handle);
+            HandleType typedOwner = HandleType(owner);
+            DataType* storedData = _assets.GetHotPtrMutable(typedHandle);
+            AssetState* state = _assets.GetColdPtrMutable(typedHandle);
+            RN_ASSERT(storedData && typedHandle != typedOwner);
+
+            Vector<Asset> releasedDependencies = MakeVector<Asset>(MemoryCategory::Asset);
+            {
+                std::unique_lock lock(_residencyMutex);
+                AssetState* ownerState = _assets.GetColdPtrMutable(typedOwner);
+                RN_ASSERT(ownerState);
+
+                if (ownerState->loadFailed)
+                {
+                    releasedDependencies.push_back(owner);
+                    FailLoad(typedHandle, *state, releasedDependencies);
+                }
+                else
+                {
+                    if (state->sharedOwner == HandleType::Invalid)
+                    {
+                        _builder->Destroy(*storedData);
+                    }
+                    DetachSharer(typedHandle, *state);
+
+                    state->sharedOwner = typedOwner;
+                    ownerState->sharers.push_back(typedHandle);
+
+                    // The reference to the owner is released like any other dependency
+                    std::swap(releasedDependencies, state->dependencies);
+                    state->dependencies.push_back(owner);
+
+                    if (ownerState->residency == Residency::Resident)
+                    {
+                        *storedData = *_assets.GetHotPtr(typedOwner);
+                        CopyToSharers(*state, *storedData);
+                        MarkSharerResident(typedHandle, *state);
+                    }
+                    else
+                    {
+                        // Rebuilt while its new owner is still loading, its previous data is gone already
+                        *storedData = DataType();
+                        if (state->residency == Residency::Resident)
+                        {
+                            --_stats.residentCount;
+                            _stats.residentBytes -= state->footprint;
+                            state->footprint = 0;
+                            state->residency = Residency::NotResident;
+                        }
+                    }
+                }
+            }
+
+            _registry->NotifyLoadCompleted();
+            for (Asset dependency : releasedDependencies)
+            {
+                _registry->Release(dependency);
+            }
+        }
+        else
+        {
+            // ShareContent never hands out owners for data which can't be copied
+            RN_ASSERT(false);
+        }
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::MarkSharerResident(HandleType handle, AssetState& state)
+    {
+        if (state.residency != Residency::Resident)
+        {
+            ++_stats.residentCount;
+        }
+
+        ++_stats.sharedCount;
+        _stats.residentBytes -= state.footprint;
+        state.footprint = 0;
+        state.residency = Residency::Resident;
+        state.loadFailed = false;
+
+        if (state.refCount.load(std::memory_order_acquire) == 0)
+        {
+            PushLRU(handle, state);
+        }
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::FailLoad(Asset handle)
+    {
+        Vector<Asset> releasedDependencies = MakeVector<Asset>(MemoryCategory::Asset);
+        {
+            std::unique_lock lock(_residencyMutex);
+            AssetState* state = _assets.GetColdPtrMutable(HandleType(handle));
+            RN_ASSERT(state);
+
+            FailLoad(HandleType(handle), *state, releasedDependencies);
+        }
+
+        _registry->NotifyLoadCompleted();
+        for (Asset dependency : releasedDependencies)
+        {
+            _registry->Release(dependency);
+        }
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::FailLoad(HandleType handle, AssetState& state, Vector<Asset>& outReleasedDependencies)
+    {
+        if (state.residency == Residency::Resident)
+        {
+            return;
+        }
+
+        // Loads with the same content mustn't share with an asset which never got built
+        auto contentIt = _contentToHandle.find(state.contentHash.lower);
+        if (contentIt != _contentToHandle.end() && contentIt->second == handle)
+        {
+            _contentToHandle.erase(contentIt);
+        }
+
+        state.loadFailed = true;
+
+        // Sharers waiting for the data fail along with the owner, and let go of it
+        for (HandleType sharer : state.sharers)
+        {
+            AssetState* sharerState = _assets.GetColdPtrMutable(sharer);
+            sharerState->sharedOwner = HandleType::Invalid;
+            sharerState->loadFailed = true;
+            outReleasedDependencies.insert(outReleasedDependencies.end(), sharerState->dependencies.begin(), sharerState->dependencies.end());
+            sharerState->dependencies.clear();
+        }
+
+        state.sharers.clear();
+    }
+
+    template <typename HandleType, typename DataType>
+    bool Bank<HandleType, DataType>::LoadFailed(Asset handle)
+    {
+        std::unique_lock lock(_residencyMutex);
+        const AssetState* state = _assets.GetColdPtr(HandleType(handle));
+        return state && state->loadFailed;
+    }
+
+    template <typename HandleType, typename DataType>
+    Asset Bank<HandleType, DataType>::FindResident(StringHash identifier)
+    {
+        HandleType handle = _identifierToHandle.Find(identifier);
+
+        std::unique_lock lock(_residencyMutex);
+        const AssetState* state = _assets.GetColdPtr(handle);
+        return (state && state->residency == Residency::Resident) ? Asset(handle) : Asset::Invalid;
+    }
+
+    template <typename HandleType, typename DataType>
+    LargeHash Bank<HandleType, DataType>::ContentHash(Asset handle)
+    {
+        std::unique_lock lock(_residencyMutex);
+        const AssetState* state = _assets.GetColdPtr(HandleType(handle));
+        return state ? state->contentHash : LargeHash{ 0, 0 };
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::CollectSharers(Asset handle, Vector<StringHash>& outIdentifiers)
+    {
+        std::unique_lock lock(_residencyMutex);
+        const AssetState* state = _assets.GetColdPtr(HandleType(handle));
+        if (!state)
+        {
+            return;
+        }
+
+        for (HandleType sharer : state->sharers)
+        {
+            outIdentifiers.push_back(_assets.GetColdPtr(sharer)->identifier);
+        }
+    }
+
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::DetachSharer(HandleType handle, AssetState& state)
+    {
+        if (state.sharedOwner == HandleType::Invalid)
+        {
+            return;
+        }
+
+        // Sharers hold a reference to their owner, so it can't have been evicted
+        AssetState* ownerState = _assets.GetColdPtrMutable(state.sharedOwner);
+        RN_ASSERT(ownerState);
+        std::erase(ownerState->sharers, handle);
+
+        state.sharedOwner = HandleType::Invalid;
+
+        // Sharers waiting for their owner to be built aren't counted yet
+        if (state.residency == Residency::Resident)
+        {
+            --_stats.sharedCount;
         }
+    }
 
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::CopyToSharers(const AssetState& state, const DataType& data)
+    {
+        if constexpr (SHARES_CONTENT)
+        {
+            for (HandleType sharer : state.sharers)
+            {
+                *_assets.GetHotPtrMutable(sharer) = data;
+
+                // Completes the loads of sharers which were waiting for the data
+                AssetState* sharerState = _assets.GetColdPtrMutable(sharer);
+                if (sharerState->residency != Residency::Resident)
+                {
+                    MarkSharerResident(sharer, *sharerState);
+                }
+            }
+        }
     }
 
     template <typename HandleType, typename DataType>
@@ -127,6 +694,62 @@ namespace rn::asset
         return state->residency;
     }
 
+    template <typename HandleType, typename DataType>
+    void Bank<HandleType, DataType>::Evict(size_t targetBytes)
+    {
+        // Dependencies are released once the locks are dropped, they may live in this very bank
+        Vector<Asset> releasedDependencies = MakeVector<Asset>(MemoryCategory::Asset);
+        {
+            std::unique_lock lock(_residencyMutex);
+
+            while (_stats.residentBytes > targetBytes && _lruHead < _lru.size())
+            {
+                LRUEntry entry = _lru[_lruHead++];
+
+                AssetState* state = _assets.GetColdPtrMutable(entry.handle);
+                if (!state || state->lruStamp != entry.lruStamp || state->residency != Residency::Resident || !ClaimForRemoval(*state))
+                {
+                    continue;
+                }
+
+                // Owners can't be evicted while anything shares their data, sharers don't own theirs
+                RN_ASSERT(state->sharers.empty());
+                if (state->sharedOwner == HandleType::Invalid)
+                {
+                    DataType* data = _assets.GetHotPtrMutable(entry.handle);
+                    _builder->Destroy(*data);
+                }
+                DetachSharer(entry.handle, *state);
+                releasedDependencies.insert(releasedDependencies.end(), state->dependencies.begin(), state->dependencies.end());
+
+                --_stats.residentCount;
+                _stats.residentBytes -= state->footprint;
+                ++_stats.evictionCount;
+                _stats.evictedBytes += state->footprint;
+
+                RemoveAsset(entry.handle, *state);
+            }
+
+            if (_lruHead == _lru.size())
+            {
+                _lru.clear();
+                _lruHead = 0;
+            }
+        }
+
+        for (Asset dependency : releasedDependencies)
+        {
+            _registry->Release(dependency);
+        }
+    }
+
+    template <typename HandleType, typename DataType>
+    AssetBankStats Bank<HandleType, DataType>::Stats()
+    {
+        std::unique_lock lock(_residencyMutex);
+        return _stats;
+    }
+
     template <typename HandleType, typename DataType>
     const DataType* Bank<HandleType, DataType>::Resolve(HandleType handle) const
     {
@@ -145,11 +768,12 @@ namespace rn::asset
     {
         // Make sure we don't have a hash or handle type collision
         RN_ASSERT(_extensionHashToBank.find(desc.identifierHash) == _extensionHashToBank.end());
-        RN_ASSERT(_handleIDToBank.find(size_t(HandleType::Salt)) == _handleIDToBank.end());
+        constexpr size_t saltIdx = size_t(HandleType::Salt) >> size_t(HandleType::SaltStart);
+        RN_ASSERT(_banksBySalt[saltIdx] == nullptr);
 
-        BankBase* newBank = TrackedNew<Bank<HandleType, DataType>>(MemoryCategory::Asset, desc);
+        BankBase* newBank = TrackedNew<Bank<HandleType, DataType>>(MemoryCategory::Asset, desc, this);
         _extensionHashToBank[desc.identifierHash] = newBank;
-        _handleIDToBank[size_t(HandleType::Salt)] = newBank;
+        _banksBySalt[saltIdx] = newBank;
     }
 
     template <typename HandleType>
@@ -158,14 +782,33 @@ namespace rn::asset
         return HandleType(LoadInternal(identifier, flags));
     }
 
-    template <typename HandleType, typename DataType>
-    const DataType* Registry::Resolve(HandleType handle) const
+    template <typename HandleType>
+    void Registry::Release(HandleType handle)
     {
-        auto bankIt = _handleIDToBank.find(size_t(HandleType::Salt));
+        Release(Asset(handle));
+    }
+
+    template <typename HandleType>
+    BankBase* Registry::BankForHandleType() const
+    {
+        constexpr size_t saltIdx = size_t(HandleType::Salt) >> size_t(HandleType::SaltStart);
+        BankBase* bank = _banksBySalt[saltIdx];
 
         // Did you forget to register this asset type?
-        RN_ASSERT(bankIt != _handleIDToBank.end());
-        const Bank<HandleType, DataType>* bank = static_cast<const Bank<HandleType, DataType>*>(bankIt->second);
+        RN_ASSERT(bank);
+        return bank;
+    }
+
+    template <typename HandleType>
+    AssetBankStats Registry::BankStats() const
+    {
+        return BankForHandleType<HandleType>()->Stats();
+    }
+
+    template <typename HandleType, typename DataType>
+    const DataType* Registry::Resolve(HandleType handle) const
+    {
+        const Bank<HandleType, DataType>* bank = static_cast<const Bank<HandleType, DataType>*>(BankForHandleType<HandleType>());
         return bank->Resolve(handle);
     }
 }
\ No newline at end of file
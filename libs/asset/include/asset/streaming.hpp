@@ -0,0 +1,110 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "asset/registry.hpp"
+#include "common/memory/hash_map.hpp"
+#include "common/memory/object_pool.hpp"
+#include "common/memory/vector.hpp"
+
+#include <chrono>
+
+namespace rn::asset
+{
+    RN_DEFINE_HANDLE(StreamRequest, 0x31)
+
+    enum class StreamPriority : uint32_t
+    {
+        Critical = 0,
+        High,
+        Normal,
+        Prefetch,
+
+        Count
+    };
+
+    enum class StreamStatus : uint32_t
+    {
+        Pending = 0,
+        InFlight,
+        Complete
+    };
+
+    struct StreamLatencyStats
+    {
+        size_t sampleCount = 0;
+        float p50Ms = 0.0f;
+        float p90Ms = 0.0f;
+        float p99Ms = 0.0f;
+        float maxMs = 0.0f;
+    };
+
+    struct StreamingQueueDesc
+    {
+        // Upper bound on the number of requests being mapped or built at any time
+        uint32_t maxInFlightRequests = 8;
+    };
+
+    // Streaming front end for the registry, meant to be driven once per frame from a single thread.
+    // Pending requests are started in priority order, then by ascending sort key (e.g. distance to the camera).
+    class StreamingQueue
+    {
+    public:
+
+        StreamingQueue(Registry* registry, const StreamingQueueDesc& desc);
+        ~StreamingQueue();
+
+        // Requesting an identifier which already has a live request coalesces onto it, raising its priority if needed.
+        // Every request needs to be released, the requested asset stays referenced until then.
+        StreamRequest       Request(std::string_view identifier, StreamPriority priority, float sortKey = 0.0f);
+        void                Reprioritize(StreamRequest request, StreamPriority priority, float sortKey = 0.0f);
+        void                Release(StreamRequest request);
+
+        StreamStatus        Status(StreamRequest request) const;
+        Asset               Result(StreamRequest request) const;
+
+        // Retires finished loads and starts pending requests until the in-flight limit is reached
+        void                Update();
+
+        size_t              PendingCount() const { return _pending.size(); }
+        size_t              InFlightCount() const { return _inFlight.size(); }
+        StreamLatencyStats  LatencyStats(StreamPriority priority) const;
+
+    private:
+
+        using Clock = std::chrono::steady_clock;
+
+        struct RequestState
+        {
+            String identifier;
+            StringHash identifierHash = 0;
+            StreamPriority priority = StreamPriority::Normal;
+            float sortKey = 0.0f;
+            uint64_t sequence = 0;
+            StreamStatus status = StreamStatus::Pending;
+            uint32_t refCount = 0;
+            Batch batch = Batch::Invalid;
+            Asset asset = Asset::Invalid;
+            Clock::time_point requestTime;
+        };
+
+        struct LatencySamples
+        {
+            Vector<float> samples = MakeVector<float>(MemoryCategory::Asset);
+            size_t next = 0;
+        };
+
+        void Retire(RequestState& state);
+        void Destroy(StreamRequest request, RequestState& state);
+
+        Registry* _registry;
+        uint32_t _maxInFlightRequests;
+        uint64_t _nextSequence = 0;
+
+        ObjectPool<StreamRequest, RequestState> _requests;
+        HashMap<StringHash, StreamRequest> _identifierToRequest = MakeHashMap<StringHash, StreamRequest>(MemoryCategory::Asset);
+        Vector<StreamRequest> _pending = MakeVector<StreamRequest>(MemoryCategory::Asset);
+        Vector<StreamRequest> _inFlight = MakeVector<StreamRequest>(MemoryCategory::Asset);
+
+        LatencySamples _latencies[size_t(StreamPriority::Count)];
+    };
+}
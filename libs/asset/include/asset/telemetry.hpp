@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "common/memory/string.hpp"
+#include "common/memory/vector.hpp"
+#include "asset/asset.hpp"
+
+#include <chrono>
+#include <mutex>
+
+namespace rn::asset
+{
+    // Timings of a single asset load, in microseconds
+    struct AssetLoadRecord
+    {
+        String identifier;
+        StringHash extensionHash = 0;
+        uint64_t bytesRead = 0;
+
+        // From the load being requested until a worker picked it up
+        uint64_t queueLatencyUs = 0;
+        uint64_t mapUs = 0;
+
+        // Includes decompression
+        uint64_t deserializeUs = 0;
+        uint64_t dependencyWaitUs = 0;
+        uint64_t buildUs = 0;
+    };
+
+    struct AssetTypeLoadStats
+    {
+        String extension;
+        StringHash extensionHash = 0;
+        size_t loadCount = 0;
+        uint64_t bytesRead = 0;
+        uint64_t queueLatencyUs = 0;
+        uint64_t mapUs = 0;
+        uint64_t deserializeUs = 0;
+        uint64_t dependencyWaitUs = 0;
+        uint64_t buildUs = 0;
+    };
+
+    // Keeps the records of the most recent asset loads and per-type totals over all of them, thread safe
+    class LoadTelemetry
+    {
+    public:
+
+        // Older records get overwritten once the limit is reached
+        static constexpr size_t MAX_RECORD_COUNT = 4096;
+
+        using Clock = std::chrono::steady_clock;
+        static uint64_t ElapsedUs(Clock::time_point start, Clock::time_point end);
+
+        void                        Record(AssetLoadRecord&& record);
+        void                        Reset();
+
+        // Oldest first
+        Vector<AssetLoadRecord>     Records() const;
+        Vector<AssetTypeLoadStats>  TypeStats() const;
+
+        // CSV holds one row per kept record. JSON holds the kept records as well as the per-type aggregates.
+        String                      ExportCSV() const;
+        String                      ExportJSON() const;
+        bool                        WriteCSV(const char* path) const;
+        bool                        WriteJSON(const char* path) const;
+
+    private:
+
+        mutable std::mutex _mutex;
+        Vector<AssetLoadRecord> _records = MakeVector<AssetLoadRecord>(MemoryCategory::Asset);
+        size_t _nextRecord = 0;
+
+        Vector<AssetTypeLoadStats> _typeStats = MakeVector<AssetTypeLoadStats>(MemoryCategory::Asset);
+        HashMap<StringHash, size_t> _extensionHashToStats = MakeHashMap<StringHash, size_t>(MemoryCategory::Asset);
+    };
+}
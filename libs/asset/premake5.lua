@@ -1,3 +1,6 @@
+include "../../contrib/projects/lz4"
+include "../../contrib/projects/zstd"
+
 project "rnAsset"
     kind "StaticLib"
     language "C++"
@@ -37,6 +40,8 @@ project "rnAsset"
 
     includedirs(RN_COMMON_INCLUDES)
     includedirs(RN_ASSET_INCLUDES)
+    includedirs(RN_LZ4_INCLUDES)
+    includedirs(RN_ZSTD_INCLUDES)
 
     libdirs {
         "%{wks.location}/%{cfg.buildcfg}"
@@ -44,7 +49,9 @@ project "rnAsset"
 
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
     
-    links { "rnCommon" }
+    links { "rnCommon", "lz4", "zstd" }
+
+include "bench"
 
 if BUILD_PROPERTIES.IncludeTestsInBuild then
     include "test"
@@ -1,8 +1,38 @@
 import "reference.lua"
 namespace "rn.asset.schema"
 
-Asset = struct {
+AssetCompression = enum {
+    value("None"),
+    value("LZ4"),
+    value("Zstd"),
+}
+
+CompressedChunk = struct {
+    field(uint32, "compressedSize"),
+    field(uint32, "uncompressedSize"),
+}
+
+-- Hashes are resolved by data_build, the path is sanitized and only kept around for diagnostics and file mapping
+AssetReference = struct {
+    field(uint64, "identifierHash"),
+    field(uint64, "extensionHash"),
+    field(String, "path"),
+}
+
+-- Hash of everything the built asset depends on: type, uncompressed payload and references.
+-- Zero for assets built before content hashes were recorded.
+ContentHash = struct {
+    field(uint64, "lower"),
+    field(uint64, "upper"),
+}
+
+-- The offset table lets the header be inspected without deserializing the references
+Asset = offset_table(struct {
     field(String, "identifier"),
-    field(span(String), "references"),
-    field(span(uint8), "assetData"),
-}
\ No newline at end of file
+    field(span(AssetReference), "references"),
+    field(AssetCompression, "compression"),
+    field(ContentHash, "contentHash"),
+    field(span(CompressedChunk), "chunks"),
+    -- Aligned to the largest alignment the payload's own schema may ask for, so it can be deserialized in place
+    field(span(uint8), "assetData", { align = 512 }),
+})
\ No newline at end of file
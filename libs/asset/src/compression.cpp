@@ -0,0 +1,310 @@
+#include "asset/compression.hpp"
+#include "asset/asset.hpp"
+#include "common/memory/memory.hpp"
+#include "common/memory/hash.hpp"
+#include "common/memory/string.hpp"
+#include "common/memory/vector.hpp"
+#include "common/task/scheduler.hpp"
+#include "TaskScheduler.h"
+
+#include "luagen/schema.hpp"
+
+#include "lz4.h"
+#include "lz4hc.h"
+#include "zstd.h"
+
+#include <atomic>
+
+namespace rn::asset
+{
+    namespace
+    {
+        constexpr const int ZSTD_COMPRESSION_LEVEL = 19;
+
+        size_t CompressBound(schema::AssetCompression compression, size_t size)
+        {
+            switch (compression)
+            {
+            case schema::AssetCompression::LZ4:
+                return size_t(LZ4_compressBound(int(size)));
+            case schema::AssetCompression::Zstd:
+                return ZSTD_compressBound(size);
+            default:
+                return size;
+            }
+        }
+
+        // Returns 0 if the chunk couldn't be compressed
+        size_t CompressChunk(schema::AssetCompression compression, Span<const uint8_t> src, Span<uint8_t> dst)
+        {
+            switch (compression)
+            {
+            case schema::AssetCompression::LZ4:
+            {
+                int result = LZ4_compress_HC(
+                    reinterpret_cast<const char*>(src.data()),
+                    reinterpret_cast<char*>(dst.data()),
+                    int(src.size()),
+                    int(dst.size()),
+                    LZ4HC_CLEVEL_DEFAULT);
+
+                return result > 0 ? size_t(result) : 0;
+            }
+            case schema::AssetCompression::Zstd:
+            {
+                size_t result = ZSTD_compress(dst.data(), dst.size(), src.data(), src.size(), ZSTD_COMPRESSION_LEVEL);
+                return ZSTD_isError(result) ? 0 : result;
+            }
+            default:
+                RN_ASSERT(false);
+                return 0;
+            }
+        }
+
+        // Returns false for corrupt chunks
+        bool DecompressChunk(schema::AssetCompression compression, Span<const uint8_t> src, Span<uint8_t> dst)
+        {
+            switch (compression)
+            {
+            case schema::AssetCompression::LZ4:
+            {
+                int result = LZ4_decompress_safe(
+                    reinterpret_cast<const char*>(src.data()),
+                    reinterpret_cast<char*>(dst.data()),
+                    int(src.size()),
+                    int(dst.size()));
+
+                return result == int(dst.size());
+            }
+            case schema::AssetCompression::Zstd:
+            {
+                size_t result = ZSTD_decompress(dst.data(), dst.size(), src.data(), src.size());
+                return !ZSTD_isError(result) && result == dst.size();
+            }
+            default:
+                return false;
+            }
+        }
+
+        struct ChunkRange
+        {
+            Span<const uint8_t> src;
+            Span<uint8_t> dst;
+        };
+    }
+
+    CompressedAssetData CompressAssetData(Span<const uint8_t> data, schema::AssetCompression compression)
+    {
+        CompressedAssetData result = {
+            .compression = schema::AssetCompression::None,
+            .chunks = {},
+            .data = { const_cast<uint8_t*>(data.data()), data.size() }
+        };
+
+        if (compression == schema::AssetCompression::None || data.empty())
+        {
+            return result;
+        }
+
+        // Chunk table first, followed by the compressed data
+        size_t chunkCount = (data.size() + COMPRESSION_CHUNK_SIZE - 1) / COMPRESSION_CHUNK_SIZE;
+        size_t chunkTableSize = AlignSize(chunkCount * sizeof(schema::CompressedChunk), CACHE_LINE_TARGET_SIZE);
+        size_t compressedCapacity = CompressBound(compression, COMPRESSION_CHUNK_SIZE) * chunkCount;
+
+        TrackedUniquePtr<uint8_t> storage(static_cast<uint8_t*>(TrackedAlloc(MemoryCategory::Asset, chunkTableSize + compressedCapacity, CACHE_LINE_TARGET_SIZE)));
+        if (!storage)
+        {
+            return result;
+        }
+
+        Span<schema::CompressedChunk> chunks = { reinterpret_cast<schema::CompressedChunk*>(storage.get()), chunkCount };
+        uint8_t* compressedData = storage.get() + chunkTableSize;
+
+        size_t compressedSize = 0;
+        for (size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+        {
+            size_t srcOffset = chunkIdx * COMPRESSION_CHUNK_SIZE;
+            Span<const uint8_t> src = data.subspan(srcOffset, std::min(COMPRESSION_CHUNK_SIZE, data.size() - srcOffset));
+            Span<uint8_t> dst = { compressedData + compressedSize, compressedCapacity - compressedSize };
+
+            size_t chunkSize = CompressChunk(compression, src, dst);
+            if (chunkSize == 0)
+            {
+                return result;
+            }
+
+            chunks[chunkIdx] = {
+                .compressedSize = uint32_t(chunkSize),
+                .uncompressedSize = uint32_t(src.size())
+            };
+
+            compressedSize += chunkSize;
+        }
+
+        if (compressedSize < data.size())
+        {
+            result.compression = compression;
+            result.chunks = chunks;
+            result.data = { compressedData, compressedSize };
+            result.storage = std::move(storage);
+        }
+
+        return result;
+    }
+
+    schema::ContentHash HashAssetContent(std::string_view extension, Span<const uint8_t> data, Span<const schema::AssetReference> references)
+    {
+        MemoryScope SCOPE;
+        const LargeHash payloadHash = HashMemory(data.data(), data.size());
+
+        ScopedVector<uint64_t> hashes;
+        hashes.reserve(3 + references.size());
+        hashes.push_back(payloadHash.lower);
+        hashes.push_back(payloadHash.upper);
+        hashes.push_back(HashString(extension));
+        for (const schema::AssetReference& reference : references)
+        {
+            hashes.push_back(reference.identifierHash);
+        }
+
+        const LargeHash contentHash = HashMemory(hashes.data(), hashes.size() * sizeof(uint64_t));
+        return {
+            .lower = contentHash.lower,
+            .upper = contentHash.upper
+        };
+    }
+
+    bool IsValidAssetFile(Span<const uint8_t> data)
+    {
+        // One offset per schema::Asset field, the first field starts right behind them
+        constexpr const uint64_t ASSET_FIELD_COUNT = 6;
+        constexpr const uint64_t OFFSET_TABLE_SIZE = ASSET_FIELD_COUNT * SERIALIZED_FIELD_OFFSET_SIZE;
+        if (data.size() < OFFSET_TABLE_SIZE)
+        {
+            return false;
+        }
+
+        uint64_t fieldOffsets[ASSET_FIELD_COUNT] = {};
+        std::memcpy(fieldOffsets, data.data(), sizeof(fieldOffsets));
+        if (fieldOffsets[0] != OFFSET_TABLE_SIZE)
+        {
+            return false;
+        }
+
+        // Fields are written in order
+        for (uint64_t fieldIdx = 1; fieldIdx < ASSET_FIELD_COUNT; ++fieldIdx)
+        {
+            if (fieldOffsets[fieldIdx] < fieldOffsets[fieldIdx - 1] || fieldOffsets[fieldIdx] > data.size())
+            {
+                return false;
+            }
+        }
+
+        // The identifier is the asset's extension, and needs to fit in front of the next field
+        uint64_t identifierLength = 0;
+        if (fieldOffsets[1] - fieldOffsets[0] < sizeof(identifierLength))
+        {
+            return false;
+        }
+
+        std::memcpy(&identifierLength, data.data() + fieldOffsets[0], sizeof(identifierLength));
+        if (identifierLength == 0 || identifierLength > fieldOffsets[1] - fieldOffsets[0] - sizeof(identifierLength))
+        {
+            return false;
+        }
+
+        return schema::Asset::Accessor(data).identifier().starts_with('.');
+    }
+
+    bool DecompressAssetData(const schema::Asset& asset, bool multithreaded, DecompressedAssetData& outData)
+    {
+        if (asset.compression == schema::AssetCompression::None)
+        {
+            outData.data = asset.assetData;
+            return true;
+        }
+
+        size_t chunkCount = asset.chunks.size();
+        Vector<ChunkRange> ranges = MakeVector<ChunkRange>(chunkCount, MemoryCategory::Asset);
+
+        size_t compressedSize = 0;
+        size_t uncompressedSize = 0;
+        for (size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+        {
+            // Chunk table doesn't match the payload
+            const schema::CompressedChunk& chunk = asset.chunks[chunkIdx];
+            if (chunk.compressedSize > asset.assetData.size() - compressedSize || chunk.uncompressedSize > COMPRESSION_CHUNK_SIZE)
+            {
+                return false;
+            }
+
+            ranges[chunkIdx].src = asset.assetData.subspan(compressedSize, chunk.compressedSize);
+
+            compressedSize += chunk.compressedSize;
+            uncompressedSize += chunk.uncompressedSize;
+        }
+
+        if (compressedSize != asset.assetData.size())
+        {
+            return false;
+        }
+
+        TrackedUniquePtr<uint8_t> storage(static_cast<uint8_t*>(TrackedAlloc(MemoryCategory::Asset, uncompressedSize, SERIALIZED_MAX_ALIGNMENT)));
+        if (!storage)
+        {
+            return false;
+        }
+
+        size_t uncompressedOffset = 0;
+        for (size_t chunkIdx = 0; chunkIdx < chunkCount; ++chunkIdx)
+        {
+            ranges[chunkIdx].dst = { storage.get() + uncompressedOffset, asset.chunks[chunkIdx].uncompressedSize };
+            uncompressedOffset += asset.chunks[chunkIdx].uncompressedSize;
+        }
+
+        struct DecompressChunksTask : enki::ITaskSet
+        {
+            schema::AssetCompression compression = schema::AssetCompression::None;
+            Span<const ChunkRange> ranges;
+            std::atomic<bool> failed = false;
+
+            void ExecuteRange(enki::TaskSetPartition range_, uint32_t threadnum_) override
+            {
+                for (uint32_t i = range_.start; i < range_.end; ++i)
+                {
+                    if (!DecompressChunk(compression, ranges[i].src, ranges[i].dst))
+                    {
+                        failed.store(true, std::memory_order_relaxed);
+                    }
+                }
+            }
+        };
+
+        DecompressChunksTask task;
+        task.compression = asset.compression;
+        task.ranges = ranges;
+        task.m_SetSize = uint32_t(chunkCount);
+
+        if (multithreaded && chunkCount > 1)
+        {
+            enki::TaskScheduler* scheduler = TaskScheduler();
+            scheduler->AddTaskSetToPipe(&task);
+
+            // Decompression runs inside of loads, which mustn't pick up low priority batch tasks while they wait
+            scheduler->WaitforTask(&task, enki::TASK_PRIORITY_MED);
+        }
+        else
+        {
+            task.ExecuteRange({ 0, task.m_SetSize }, 0);
+        }
+
+        if (task.failed.load(std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        outData.data = { storage.get(), uncompressedSize };
+        outData.storage = std::move(storage);
+        return true;
+    }
+}
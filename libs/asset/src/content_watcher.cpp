@@ -0,0 +1,174 @@
+#include "asset/content_watcher.hpp"
+#include "common/log/log.hpp"
+
+#include <algorithm>
+
+#if RN_PLATFORM_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#endif
+
+namespace rn::asset
+{
+    RN_LOG_CATEGORY(Asset);
+
+#if RN_PLATFORM_WINDOWS
+    struct ContentWatcher::PlatformState
+    {
+        HANDLE directory = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        bool readPending = false;
+
+        // Notifications are variable sized records, aligned to DWORDs
+        alignas(DWORD) uint8_t buffer[64 * KILO];
+
+        void IssueRead()
+        {
+            constexpr const DWORD NOTIFY_FILTER = FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE;
+            readPending = ReadDirectoryChangesW(directory, buffer, DWORD(sizeof(buffer)), TRUE, NOTIFY_FILTER, nullptr, &overlapped, nullptr) != FALSE;
+        }
+    };
+
+    ContentWatcher::ContentWatcher(const char* directory, Clock::duration settleTime)
+        : _settleTime(settleTime)
+        , _platform(MakeUniqueTracked<PlatformState>(MemoryCategory::Asset))
+    {
+        _platform->directory = CreateFileA(directory,
+            FILE_LIST_DIRECTORY,
+            FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+            nullptr);
+
+        if (_platform->directory == INVALID_HANDLE_VALUE)
+        {
+            LogError(LogCategory::Asset, "Failed to watch content directory \"{}\"", directory);
+            return;
+        }
+
+        _platform->overlapped.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+        _platform->IssueRead();
+    }
+
+    ContentWatcher::~ContentWatcher()
+    {
+        if (_platform->directory != INVALID_HANDLE_VALUE)
+        {
+            if (_platform->readPending)
+            {
+                // The read writes into our buffer until it's been cancelled
+                DWORD bytesTransferred = 0;
+                CancelIoEx(_platform->directory, &_platform->overlapped);
+                GetOverlappedResult(_platform->directory, &_platform->overlapped, &bytesTransferred, TRUE);
+            }
+
+            CloseHandle(_platform->overlapped.hEvent);
+            CloseHandle(_platform->directory);
+        }
+    }
+
+    bool ContentWatcher::IsValid() const
+    {
+        return _platform->directory != INVALID_HANDLE_VALUE;
+    }
+
+    void ContentWatcher::ReadPlatformChanges()
+    {
+        DWORD bytesTransferred = 0;
+        while (_platform->readPending && GetOverlappedResult(_platform->directory, &_platform->overlapped, &bytesTransferred, FALSE))
+        {
+            Clock::time_point now = Clock::now();
+
+            // Zero bytes means more changes happened than fit the buffer, all of them are lost
+            if (bytesTransferred == 0)
+            {
+                LogWarning(LogCategory::Asset, "Too many content changes at once, some of them won't be reloaded");
+            }
+
+            const uint8_t* record = _platform->buffer;
+            while (bytesTransferred > 0)
+            {
+                const FILE_NOTIFY_INFORMATION* info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+                if (info->Action == FILE_ACTION_ADDED || info->Action == FILE_ACTION_MODIFIED || info->Action == FILE_ACTION_RENAMED_NEW_NAME)
+                {
+                    int wideLength = int(info->FileNameLength / sizeof(WCHAR));
+                    int length = WideCharToMultiByte(CP_UTF8, 0, info->FileName, wideLength, nullptr, 0, nullptr, nullptr);
+
+                    String path(size_t(length), '\0');
+                    WideCharToMultiByte(CP_UTF8, 0, info->FileName, wideLength, path.data(), length, nullptr, nullptr);
+                    AddPendingChange(std::move(path), now);
+                }
+
+                if (info->NextEntryOffset == 0)
+                {
+                    break;
+                }
+
+                record += info->NextEntryOffset;
+            }
+
+            ResetEvent(_platform->overlapped.hEvent);
+            _platform->IssueRead();
+        }
+    }
+#else
+    #error ContentWatcher not implemented on this platform
+#endif
+
+    void ContentWatcher::AddPendingChange(String&& path, Clock::time_point time)
+    {
+        std::replace(path.begin(), path.end(), '\\', '/');
+
+        auto it = std::find_if(_pendingChanges.begin(), _pendingChanges.end(), [&path](const PendingChange& change)
+        {
+            return change.path == path;
+        });
+
+        if (it != _pendingChanges.end())
+        {
+            it->lastChange = time;
+            return;
+        }
+
+        _pendingChanges.push_back({
+            .path = std::move(path),
+            .lastChange = time
+        });
+    }
+
+    Span<const std::string_view> ContentWatcher::PollChanges()
+    {
+        _changes.clear();
+        _changeViews.clear();
+
+        if (!IsValid())
+        {
+            return {};
+        }
+
+        ReadPlatformChanges();
+
+        // Writes usually come in as several notifications, wait for the last one before reporting the file
+        Clock::time_point now = Clock::now();
+        for (auto it = _pendingChanges.begin(); it != _pendingChanges.end();)
+        {
+            if (now - it->lastChange < _settleTime)
+            {
+                ++it;
+                continue;
+            }
+
+            _changes.push_back(std::move(it->path));
+            it = _pendingChanges.erase(it);
+        }
+
+        for (const String& change : _changes)
+        {
+            _changeViews.push_back(change);
+        }
+
+        return _changeViews;
+    }
+}
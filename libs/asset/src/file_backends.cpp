@@ -0,0 +1,271 @@
+#include "asset/registry.hpp"
+#include "common/memory/vector.hpp"
+
+#include <bit>
+
+#if RN_PLATFORM_WINDOWS
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#endif
+
+namespace rn::asset
+{
+    namespace
+    {
+        // Unbuffered reads need sector aligned offsets, sizes and buffers
+        constexpr const size_t UNBUFFERED_IO_ALIGNMENT = 4096;
+        constexpr const size_t READ_REQUEST_SIZE = 1024 * 1024;
+        constexpr const size_t MAX_READS_IN_FLIGHT = 8;
+
+        // Buffers are pooled in power of two size classes, from 64 KiB up
+        constexpr const size_t MIN_POOLED_BUFFER_SIZE_LOG2 = 16;
+        constexpr const size_t POOLED_BUFFER_SIZE_CLASS_COUNT = 16;
+        constexpr const size_t MAX_POOLED_BUFFERS_PER_SIZE_CLASS = 4;
+
+        class ReadBufferPool
+        {
+        public:
+
+            ~ReadBufferPool()
+            {
+                for (Vector<uint8_t*>& buffers : _freeBuffers)
+                {
+                    for (uint8_t* buffer : buffers)
+                    {
+                        TrackedFree(buffer);
+                    }
+                }
+            }
+
+            static size_t SizeClass(size_t size)
+            {
+                size_t sizeLog2 = std::bit_width(std::bit_ceil(size)) - 1;
+                return sizeLog2 > MIN_POOLED_BUFFER_SIZE_LOG2 ? sizeLog2 - MIN_POOLED_BUFFER_SIZE_LOG2 : 0;
+            }
+
+            static size_t SizeClassCapacity(size_t sizeClass)
+            {
+                return size_t(1) << (sizeClass + MIN_POOLED_BUFFER_SIZE_LOG2);
+            }
+
+            std::pair<uint8_t*, size_t> Acquire(size_t size)
+            {
+                size_t sizeClass = SizeClass(size);
+                if (sizeClass < POOLED_BUFFER_SIZE_CLASS_COUNT)
+                {
+                    std::unique_lock lock(_mutex);
+                    Vector<uint8_t*>& buffers = _freeBuffers[sizeClass];
+                    if (!buffers.empty())
+                    {
+                        uint8_t* buffer = buffers.back();
+                        buffers.pop_back();
+                        return std::make_pair(buffer, SizeClassCapacity(sizeClass));
+                    }
+                }
+
+                size_t capacity = SizeClassCapacity(sizeClass);
+                return std::make_pair(static_cast<uint8_t*>(TrackedAlloc(MemoryCategory::Asset, capacity, UNBUFFERED_IO_ALIGNMENT)), capacity);
+            }
+
+            void Return(uint8_t* buffer, size_t capacity)
+            {
+                size_t sizeClass = SizeClass(capacity);
+                if (sizeClass < POOLED_BUFFER_SIZE_CLASS_COUNT)
+                {
+                    std::unique_lock lock(_mutex);
+                    Vector<uint8_t*>& buffers = _freeBuffers[sizeClass];
+                    if (buffers.size() < MAX_POOLED_BUFFERS_PER_SIZE_CLASS)
+                    {
+                        buffers.push_back(buffer);
+                        return;
+                    }
+                }
+
+                TrackedFree(buffer);
+            }
+
+        private:
+
+            std::mutex _mutex;
+            Vector<uint8_t*> _freeBuffers[POOLED_BUFFER_SIZE_CLASS_COUNT];
+        };
+
+        ReadBufferPool& ReadBuffers()
+        {
+            static ReadBufferPool pool;
+            return pool;
+        }
+
+        class ReadFileAssetData : public MappedAsset
+        {
+        public:
+            ReadFileAssetData(uint8_t* buffer, size_t capacity, size_t size)
+                : _buffer(buffer)
+                , _capacity(capacity)
+                , _size(size)
+            {}
+
+            ~ReadFileAssetData()
+            {
+                ReadBuffers().Return(_buffer, _capacity);
+            }
+
+            virtual Span<const uint8_t> Ptr() const override { return { _buffer, _size }; }
+
+            uint8_t* _buffer;
+            size_t _capacity;
+            size_t _size;
+        };
+
+        class PrefetchedFileAsset : public MappedAsset
+        {
+        public:
+            PrefetchedFileAsset(TrackedUniquePtr<MappedAsset>&& mapping)
+                : _mapping(std::move(mapping))
+            {
+                Span<const uint8_t> data = _mapping->Ptr();
+
+            #if RN_PLATFORM_WINDOWS
+                WIN32_MEMORY_RANGE_ENTRY range = {
+                    .VirtualAddress = const_cast<uint8_t*>(data.data()),
+                    .NumberOfBytes = data.size()
+                };
+
+                // Only a hint, mapped pages still fault in on first touch if the prefetch didn't get to them
+                PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+            #else
+                #error PrefetchedFileAsset not implemented on this platform
+            #endif
+            }
+
+            virtual Span<const uint8_t> Ptr() const override { return _mapping->Ptr(); }
+
+            TrackedUniquePtr<MappedAsset> _mapping;
+        };
+    }
+
+    TrackedUniquePtr<MappedAsset> MapFileAssetPrefetched(const String& path)
+    {
+        TrackedUniquePtr<MappedAsset> mapping = MapFileAsset(path);
+        if (!mapping)
+        {
+            return nullptr;
+        }
+
+        return TrackedUniquePtr<MappedAsset>(TrackedNew<PrefetchedFileAsset>(MemoryCategory::Asset, std::move(mapping)));
+    }
+
+    TrackedUniquePtr<MappedAsset> ReadFileAsset(const String& path)
+    {
+    #if RN_PLATFORM_WINDOWS
+        HANDLE file = CreateFileA(path.c_str(),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN,
+            nullptr);
+
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        size_t size = size_t(fileSize.QuadPart);
+        size_t alignedSize = AlignSize(size, UNBUFFERED_IO_ALIGNMENT);
+        std::pair<uint8_t*, size_t> buffer = ReadBuffers().Acquire(std::max(alignedSize, UNBUFFERED_IO_ALIGNMENT));
+        if (!buffer.first)
+        {
+            CloseHandle(file);
+            return nullptr;
+        }
+
+        bool readFailed = false;
+        OVERLAPPED reads[MAX_READS_IN_FLIGHT] = {};
+        for (OVERLAPPED& read : reads)
+        {
+            read.hEvent = CreateEventA(nullptr, TRUE, FALSE, nullptr);
+            readFailed |= read.hEvent == nullptr;
+        }
+
+        // Keep a window of reads in flight, retiring them in issue order
+        size_t requestCount = (alignedSize + READ_REQUEST_SIZE - 1) / READ_REQUEST_SIZE;
+        size_t issuedCount = 0;
+        size_t completedCount = 0;
+        size_t bytesReadTotal = 0;
+        while (!readFailed && completedCount < requestCount)
+        {
+            while (issuedCount < requestCount && issuedCount - completedCount < MAX_READS_IN_FLIGHT)
+            {
+                OVERLAPPED& read = reads[issuedCount % MAX_READS_IN_FLIGHT];
+                uint64_t offset = uint64_t(issuedCount) * READ_REQUEST_SIZE;
+                DWORD readSize = DWORD(std::min<uint64_t>(READ_REQUEST_SIZE, alignedSize - offset));
+
+                read.Offset = DWORD(offset & 0xFFFFFFFF);
+                read.OffsetHigh = DWORD(offset >> 32);
+                ResetEvent(read.hEvent);
+
+                // Reads which failed to start never signal their event
+                if (!ReadFile(file, buffer.first + offset, readSize, nullptr, &read) && GetLastError() != ERROR_IO_PENDING)
+                {
+                    readFailed = true;
+                    break;
+                }
+                ++issuedCount;
+            }
+
+            if (readFailed)
+            {
+                break;
+            }
+
+            DWORD bytesRead = 0;
+            BOOL result = GetOverlappedResult(file, &reads[completedCount % MAX_READS_IN_FLIGHT], &bytesRead, TRUE);
+            ++completedCount;
+
+            readFailed = !result && GetLastError() != ERROR_HANDLE_EOF;
+            bytesReadTotal += bytesRead;
+        }
+
+        if (readFailed)
+        {
+            // Reads still in flight write into the buffer, so they need to drain before it can be reused
+            CancelIoEx(file, nullptr);
+            for (; completedCount < issuedCount; ++completedCount)
+            {
+                DWORD bytesRead = 0;
+                GetOverlappedResult(file, &reads[completedCount % MAX_READS_IN_FLIGHT], &bytesRead, TRUE);
+            }
+        }
+
+        for (OVERLAPPED& read : reads)
+        {
+            if (read.hEvent)
+            {
+                CloseHandle(read.hEvent);
+            }
+        }
+
+        CloseHandle(file);
+
+        // Files which got truncated while being read come up short
+        if (readFailed || bytesReadTotal < size)
+        {
+            ReadBuffers().Return(buffer.first, buffer.second);
+            return nullptr;
+        }
+
+        return TrackedUniquePtr<MappedAsset>(TrackedNew<ReadFileAssetData>(MemoryCategory::Asset, buffer.first, buffer.second, size));
+    #else
+        #error ReadFileAsset not implemented on this platform
+    #endif
+    }
+}
@@ -0,0 +1,70 @@
+#include "asset/manifest.hpp"
+
+#include <algorithm>
+
+namespace rn::asset
+{
+    Manifest::Manifest(const String& path, FnMapAsset onMapAsset)
+    {
+        _mapping = onMapAsset(path);
+        if (!_mapping || _mapping->Ptr().size() < sizeof(ManifestHeader))
+        {
+            return;
+        }
+
+        Span<const uint8_t> data = _mapping->Ptr();
+        const ManifestHeader* header = reinterpret_cast<const ManifestHeader*>(data.data());
+        uint64_t entriesOffset = sizeof(ManifestHeader);
+        uint64_t closureOffset = entriesOffset + header->entryCount * sizeof(ManifestEntry);
+        uint64_t pathsOffset = closureOffset + header->closureIndexCount * sizeof(uint32_t);
+
+        if (header->magic != MANIFEST_MAGIC ||
+            header->version != MANIFEST_VERSION ||
+            data.size() < pathsOffset + header->pathSizeInBytes)
+        {
+            return;
+        }
+
+        _entries = { reinterpret_cast<const ManifestEntry*>(data.data() + entriesOffset), header->entryCount };
+        _closureIndices = { reinterpret_cast<const uint32_t*>(data.data() + closureOffset), header->closureIndexCount };
+        _paths = { reinterpret_cast<const char*>(data.data() + pathsOffset), header->pathSizeInBytes };
+    }
+
+    bool Manifest::IsValid() const
+    {
+        return _mapping && !_entries.empty();
+    }
+
+    const ManifestEntry* Manifest::Find(StringHash identifierHash) const
+    {
+        auto it = std::lower_bound(_entries.begin(), _entries.end(), identifierHash, [](const ManifestEntry& entry, StringHash hash)
+        {
+            return entry.identifierHash < hash;
+        });
+
+        if (it == _entries.end() || it->identifierHash != identifierHash)
+        {
+            return nullptr;
+        }
+
+        return &*it;
+    }
+
+    const ManifestEntry& Manifest::Entry(uint32_t entryIdx) const
+    {
+        RN_ASSERT(entryIdx < _entries.size());
+        return _entries[entryIdx];
+    }
+
+    Span<const uint32_t> Manifest::Closure(const ManifestEntry& entry) const
+    {
+        RN_ASSERT(entry.closureOffset + entry.closureCount <= _closureIndices.size());
+        return _closureIndices.subspan(entry.closureOffset, entry.closureCount);
+    }
+
+    std::string_view Manifest::Path(const ManifestEntry& entry) const
+    {
+        RN_ASSERT(entry.pathOffset + entry.pathLength <= _paths.size());
+        return _paths.substr(entry.pathOffset, entry.pathLength);
+    }
+}
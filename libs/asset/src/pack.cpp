@@ -0,0 +1,148 @@
+#include "asset/pack.hpp"
+#include "path.hpp"
+
+#include "common/log/log.hpp"
+#include "common/memory/vector.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <shared_mutex>
+
+namespace rn::asset
+{
+    RN_LOG_CATEGORY(Asset);
+
+    namespace
+    {
+        class PackedAsset : public MappedAsset
+        {
+        public:
+            PackedAsset(Span<const uint8_t> data)
+                : _data(data)
+            {}
+
+            virtual Span<const uint8_t> Ptr() const override { return _data; }
+
+            Span<const uint8_t> _data;
+        };
+
+        struct MountedPack
+        {
+            String mountPrefix;
+            TrackedUniquePtr<Pack> pack;
+        };
+
+        struct MountedPacks
+        {
+            std::shared_mutex mutex;
+            Vector<MountedPack> packs = MakeVector<MountedPack>(MemoryCategory::Asset);
+        };
+
+        MountedPacks& Mounted()
+        {
+            static MountedPacks mounted;
+            return mounted;
+        }
+    }
+
+    Pack::Pack(const String& path)
+    {
+        if (!std::filesystem::exists(path))
+        {
+            return;
+        }
+
+        _mapping = MapFileAsset(path);
+        if (!_mapping || _mapping->Ptr().size() < sizeof(PackHeader))
+        {
+            return;
+        }
+
+        Span<const uint8_t> data = _mapping->Ptr();
+        const PackHeader* header = reinterpret_cast<const PackHeader*>(data.data());
+        if (header->magic != PACK_MAGIC || 
+            header->version != PACK_VERSION ||
+            data.size() < sizeof(PackHeader) + header->entryCount * sizeof(PackEntry))
+        {
+            return;
+        }
+
+        _toc = { reinterpret_cast<const PackEntry*>(data.data() + sizeof(PackHeader)), header->entryCount };
+    }
+
+    bool Pack::IsValid() const
+    {
+        return _mapping && !_toc.empty();
+    }
+
+    Span<const uint8_t> Pack::Find(StringHash identifierHash) const
+    {
+        auto it = std::lower_bound(_toc.begin(), _toc.end(), identifierHash, [](const PackEntry& entry, StringHash hash)
+        {
+            return entry.identifierHash < hash;
+        });
+
+        if (it == _toc.end() || it->identifierHash != identifierHash)
+        {
+            return {};
+        }
+
+        Span<const uint8_t> data = _mapping->Ptr();
+        RN_ASSERT(it->offsetInBytes + it->sizeInBytes <= data.size());
+
+        return data.subspan(it->offsetInBytes, it->sizeInBytes);
+    }
+
+    bool MountPack(const String& path, const String& mountPrefix)
+    {
+        TrackedUniquePtr<Pack> pack = MakeUniqueTracked<Pack>(MemoryCategory::Asset, path);
+        if (!pack->IsValid())
+        {
+            LogError(LogCategory::Asset, "Failed to mount asset pack \"{}\"", path.c_str());
+            return false;
+        }
+
+        String sanitizedPrefix = mountPrefix;
+        SanitizePath(sanitizedPrefix, true);
+
+        MountedPacks& mounted = Mounted();
+        std::unique_lock lock(mounted.mutex);
+        mounted.packs.push_back({
+            .mountPrefix = std::move(sanitizedPrefix),
+            .pack = std::move(pack)
+        });
+
+        return true;
+    }
+
+    void UnmountPacks()
+    {
+        MountedPacks& mounted = Mounted();
+        std::unique_lock lock(mounted.mutex);
+        mounted.packs.clear();
+    }
+
+    TrackedUniquePtr<MappedAsset> MapPackedAsset(const String& path)
+    {
+        {
+            MountedPacks& mounted = Mounted();
+            std::shared_lock lock(mounted.mutex);
+            for (const MountedPack& mountedPack : mounted.packs)
+            {
+                if (!path.starts_with(mountedPack.mountPrefix))
+                {
+                    continue;
+                }
+
+                std::string_view identifier = std::string_view(path).substr(mountedPack.mountPrefix.size());
+                Span<const uint8_t> data = mountedPack.pack->Find(HashString(identifier));
+                if (!data.empty())
+                {
+                    return TrackedUniquePtr<MappedAsset>(TrackedNew<PackedAsset>(MemoryCategory::Asset, data));
+                }
+            }
+        }
+
+        return MapFileAsset(path);
+    }
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "common/memory/string.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+namespace rn::asset
+{
+    inline const std::string_view PathExtension(const std::string_view& path)
+    {
+        size_t extOffset = path.find_last_of('.');
+        if (extOffset == std::string_view::npos)
+        {
+            return {};
+        }
+
+        return path.substr(extOffset);
+    }
+
+    inline void SanitizePath(String& path, bool maintainTrailingSlash = false)
+    {
+        // Forward slashes only
+        std::replace(path.begin(), path.end(), '\\', '/');
+
+        // All lower case
+        std::transform(path.begin(), path.end(), path.begin(), [](char c)
+        {
+            return std::tolower(c);
+        });
+
+        // No trailing slashes
+        if (!maintainTrailingSlash && path.ends_with("/"))
+        {
+            path.pop_back();
+        }
+    }
+}
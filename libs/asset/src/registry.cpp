@@ -1,5 +1,9 @@
 #include "asset/registry.hpp"
+#include "asset/compression.hpp"
+#include "asset/manifest.hpp"
+#include "path.hpp"
 #include "common/memory/string.hpp"
+#include "common/memory/hash_set.hpp"
 #include "common/log/log.hpp"
 #include "mio/mio.hpp"
 
@@ -16,44 +20,17 @@ namespace rn::asset
 
     namespace
     {
-        const std::string_view PathExtension(const std::string_view& path)
-        {
-            size_t extOffset = path.find_last_of('.');
-            if (extOffset == std::string_view::npos)
-            {
-                return {};
-            }
-
-            return path.substr(extOffset);
-        }
-
-        void SanitizePath(String& path, bool maintainTrailingSlash = false)
-        {
-            // Forward slashes only
-            std::replace(path.begin(), path.end(), '\\', '/');
-
-            // All lower case
-            std::transform(path.begin(), path.end(), path.begin(), [](char c)
-            {
-                return std::tolower(c);
-            });
-
-            // No trailing slashes
-            if (!maintainTrailingSlash && path.ends_with("/"))
-            {
-                path.pop_back();
-            }
-        }
+        // Batches run at low priority, and waits inside of loads only run tasks above it. Otherwise a batch could start
+        // on top of a load it ends up waiting on, which can't continue until the batch returns.
+        constexpr const enki::TaskPriority BATCH_TASK_PRIORITY = enki::TASK_PRIORITY_LOW;
+        constexpr const enki::TaskPriority LOAD_WAIT_PRIORITY = enki::TASK_PRIORITY_MED;
 
         class MappedFileAsset : public MappedAsset
         {
         public:
-            MappedFileAsset(const String& path)
+            MappedFileAsset(const String& path, std::error_code& outErr)
             {
-                std::error_code err;
-                _source.map(path.c_str(), err);
-
-                RN_ASSERT(err.value() == 0);
+                _source.map(path.c_str(), outErr);
             }
 
             virtual Span<const uint8_t> Ptr() const override { return { reinterpret_cast<const uint8_t*>(_source.data()), _source.length() }; }
@@ -62,17 +39,32 @@ namespace rn::asset
         };
     }
 
-    MappedAsset* MapFileAsset(MemoryScope& scope, const String& path)
+    TrackedUniquePtr<MappedAsset> MapFileAsset(const String& path)
     {
-        return ScopedNew<MappedFileAsset>(scope, path);
+        std::error_code err;
+        TrackedUniquePtr<MappedAsset> mapping(TrackedNew<MappedFileAsset>(MemoryCategory::Asset, path, err));
+        if (err)
+        {
+            return nullptr;
+        }
+
+        return mapping;
     }
 
     Registry::Registry(const RegistryDesc& desc)
         : _contentPrefix(desc.contentPrefix)
         , _enableMultithreadedLoad(desc.enableMultithreadedLoad)
         , _onMapAsset(desc.onMapAsset)
+        , _manifest(desc.manifest)
+        , _enableHotReload(desc.enableHotReload)
+        , _batches(MemoryCategory::Asset, 16)
     {
         SanitizePath(_contentPrefix, true);
+
+        if (desc.enableLoadTelemetry)
+        {
+            _telemetry = MakeUniqueTracked<LoadTelemetry>(MemoryCategory::Asset);
+        }
     }
 
     Registry::~Registry()
@@ -83,51 +75,152 @@ namespace rn::asset
         }
 
         _extensionHashToBank.clear();
-        _handleIDToBank.clear();
+        _banksBySalt = {};
     }
 
-    Asset Registry::LoadInternal(std::string_view identifier, LoadFlags flags)
+    BankBase* Registry::BankForPath(std::string_view path) const
     {
-        MemoryScope SCOPE;
-        String path = { identifier.data(), identifier.size() };
-
-        SanitizePath(path);
         const std::string_view ext = PathExtension(path);
 
         // Invalid identifier
         RN_ASSERT(!ext.empty());
-        StringHash extHash = HashString(ext);
+        return BankForExtensionHash(HashString(ext));
+    }
 
-        auto bankIt = _extensionHashToBank.find(extHash);
+    BankBase* Registry::BankForExtensionHash(StringHash extensionHash) const
+    {
+        auto bankIt = _extensionHashToBank.find(extensionHash);
 
         // Did you forget to register this asset type?
         RN_ASSERT(bankIt != _extensionHashToBank.end());
+        return bankIt->second;
+    }
 
-        StringHash identifierHash = HashString(path);
-        BankBase* bank = bankIt->second;
+    BankBase* Registry::BankForAsset(Asset asset) const
+    {
+        // Asset handles carry the salt of their typed handle in the top byte
+        BankBase* bank = _banksBySalt[size_t(uint64_t(asset) >> 56)];
+
+        // Not a handle to a registered asset type
+        RN_ASSERT(bank);
+        return bank;
+    }
+
+    void Registry::Release(Asset asset)
+    {
+        BankForAsset(asset)->Release(asset);
+    }
+
+    void Registry::EvictUnreferenced()
+    {
+        // Evicting an asset releases its dependencies, which may in turn become unreferenced
+        size_t evictionCount = 0;
+        size_t prevEvictionCount = 0;
+        do
+        {
+            prevEvictionCount = evictionCount;
+            evictionCount = 0;
+
+            for (BankBase* bank : _banksBySalt)
+            {
+                if (bank)
+                {
+                    bank->Evict(0);
+                    evictionCount += bank->Stats().evictionCount;
+                }
+            }
+        } while (evictionCount != prevEvictionCount);
+    }
 
-        bool doReload = TestFlag(flags, LoadFlags::Reload);
+    Asset Registry::LoadInternal(std::string_view identifier, LoadFlags flags)
+    {
+        MemoryScope SCOPE;
+        String path = { identifier.data(), identifier.size() };
+
+        SanitizePath(path);
+        return LoadResolved(HashString(path), BankForPath(path), path, flags);
+    }
+
+    Asset Registry::LoadResolved(StringHash identifierHash, BankBase* bank, std::string_view path, LoadFlags flags, LoadTelemetry::Clock::time_point queuedAt)
+    {
+        MemoryScope SCOPE;
+
+        bool doReload = TestFlag(flags, LoadFlags::Reload) || TestFlag(flags, LoadFlags::ReloadShallow);
+        const LoadFlags referenceFlags = flags & ~LoadFlags::ReloadShallow;
         std::pair<bool, Asset> handle = bank->FindOrAllocateHandle(identifierHash);
         if (handle.first || (!handle.first && doReload))
         {
             // We're either loading a new asset (i.e. it didn't exist before) or we're forcibly reloading an asset
             LogInfo(LogCategory::Asset, "{} asset \"{}\" at handle 0x{:x}",
                 doReload ? "Reloading" : "Loading",
-                path.c_str(),
+                path,
                 size_t(handle.second));
 
+            using Clock = LoadTelemetry::Clock;
+            auto fnNow = [this]() { return _telemetry ? Clock::now() : Clock::time_point(); };
+
+            Clock::time_point loadStart = fnNow();
             String fullPath = _contentPrefix;
             fullPath.append(path);
 
-            MappedAsset* mapping = _onMapAsset(SCOPE, fullPath);
+            TrackedUniquePtr<MappedAsset> mapping = _onMapAsset(fullPath);
+            Clock::time_point mapEnd = fnNow();
+
+            if (!mapping || !IsValidAssetFile(mapping->Ptr()))
+            {
+                LogError(LogCategory::Asset, "Failed to load asset \"{}\", the file is missing or not a valid asset file", path);
+                FailLoad(bank, handle.second, {});
+                return handle.second;
+            }
 
-            // File is not a valid asset file
-            
             auto fnAlloc = [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); };
 
-            const schema::Asset asset = rn::Deserialize<schema::Asset>(mapping->Ptr(), fnAlloc);
+            // The payload is the bulk of the file, so the asset points into the mapping rather than being copied out of it
+            const schema::Asset asset = DeserializeView<schema::Asset>(mapping->Ptr(), fnAlloc);
+            if (_enableHotReload)
+            {
+                RecordHotReloadEntry(identifierHash, bank, path, asset.references);
+            }
 
-            if (_enableMultithreadedLoad)
+            // Identical content loaded under another identifier already holds the references, nothing left to build
+            const Asset contentOwner = bank->ShareContent(handle.second, { asset.contentHash.lower, asset.contentHash.upper });
+            const bool sharesContent = contentOwner != handle.second;
+
+            DecompressedAssetData assetData;
+            if (!sharesContent && !DecompressAssetData(asset, _enableMultithreadedLoad, assetData))
+            {
+                LogError(LogCategory::Asset, "Failed to load asset \"{}\", its payload is corrupt or couldn't be decompressed", path);
+                FailLoad(bank, handle.second, {});
+                return handle.second;
+            }
+            Clock::time_point deserializeEnd = fnNow();
+
+            AssetLoadRecord record;
+            if (_telemetry)
+            {
+                record.identifier = { path.data(), path.size() };
+                record.extensionHash = HashString(PathExtension(path));
+                record.bytesRead = mapping->Ptr().size();
+                record.queueLatencyUs = queuedAt != Clock::time_point() ? LoadTelemetry::ElapsedUs(queuedAt, loadStart) : 0;
+                record.mapUs = LoadTelemetry::ElapsedUs(loadStart, mapEnd);
+                record.deserializeUs = LoadTelemetry::ElapsedUs(mapEnd, deserializeEnd);
+            }
+
+            // Uncompressed payloads are handed to the builder straight out of the mapping
+            TrackedUniquePtr<MappedAsset>* assetDataMapping = asset.compression == schema::AssetCompression::None ? &mapping : nullptr;
+
+            if (sharesContent)
+            {
+                LogInfo(LogCategory::Asset, "Asset \"{}\" shares its content with handle 0x{:x}", path, size_t(contentOwner));
+
+                // Owners which are still being loaded on another thread hand their data over once they're built
+                Clock::time_point buildStart = fnNow();
+                bank->StoreShared(handle.second, contentOwner);
+
+                record.dependencyWaitUs = LoadTelemetry::ElapsedUs(deserializeEnd, buildStart);
+                record.buildUs = LoadTelemetry::ElapsedUs(buildStart, fnNow());
+            }
+            else if (_enableMultithreadedLoad)
             {
                 enki::TaskScheduler* scheduler = TaskScheduler();
 
@@ -136,12 +229,18 @@ namespace rn::asset
                     Registry* registry = nullptr;
                     BankBase* bank = nullptr;
                     const schema::Asset* asset = nullptr;
+                    Span<const uint8_t> assetData;
+                    TrackedUniquePtr<MappedAsset>* assetDataMapping = nullptr;
                     Asset destHandle = Asset::Invalid;
-                    std::string_view identifier;
-                    String path;
+                    std::string_view path;
 
                     Span<Asset> dependencies;
+                    Span<BankBase*> dependencyBanks;
                     bool doReschedule = false;
+                    bool dependencyFailed = false;
+                    bool recordTelemetry = false;
+                    Clock::time_point buildStart;
+                    Clock::time_point buildEnd;
 
                     void ExecuteRange(enki::TaskSetPartition range_, uint32_t threadnum_) override 
                     {
@@ -149,19 +248,17 @@ namespace rn::asset
                         uint32_t dependencyIdx = 0;
                         for (Asset dependency : dependencies)
                         {
-                            std::string_view ext = PathExtension(asset->references[dependencyIdx]);
-                            StringHash extHash = HashString(ext);
-
-                            auto bankIt = registry->_extensionHashToBank.find(extHash);
-                            RN_ASSERT(bankIt != registry->_extensionHashToBank.end());
-
-                            BankBase* dependencyBank = bankIt->second;
-                            if (dependencyBank->AssetResidency(dependency) != Residency::Resident)
+                            if (dependencyBanks[dependencyIdx]->AssetResidency(dependency) != Residency::Resident)
                             {
-                                LogInfo(LogCategory::Asset, "Asset \"{}\" is waiting on dependency {} ({})", 
-                                    path.c_str(), 
-                                    dependencyIdx,
-                                    asset->references[dependencyIdx]);
+                                // Nothing left to wait for once a dependency failed to load
+                                dependencyFailed = dependencyBanks[dependencyIdx]->LoadFailed(dependency);
+                                if (!dependencyFailed)
+                                {
+                                    LogInfo(LogCategory::Asset, "Asset \"{}\" is waiting on dependency {} ({})", 
+                                        path, 
+                                        dependencyIdx,
+                                        asset->references[dependencyIdx].path);
+                                }
                                 allDependenciesResident = false;
                                 break;
                             }
@@ -170,14 +267,17 @@ namespace rn::asset
 
                         if (allDependenciesResident)
                         {
+                            buildStart = recordTelemetry ? Clock::now() : Clock::time_point();
                             bank->Store(destHandle, {
-                                .identifier = identifier,
-                                .data = asset->assetData,
+                                .identifier = path,
+                                .data = assetData,
                                 .dependencies = dependencies,
-                                .registry = registry
+                                .registry = registry,
+                                .mapping = assetDataMapping
                             });
+                            buildEnd = recordTelemetry ? Clock::now() : Clock::time_point();
                         }
-                        else
+                        else if (!dependencyFailed)
                         {
                             // Reschedule if our dependencies aren't ready yet
                             doReschedule = true;
@@ -188,13 +288,15 @@ namespace rn::asset
                 struct ResolveAssetDependencyTask : enki::ITaskSet
                 {
                     Registry* registry;
-                    String referencePath;
+                    const schema::AssetReference* reference;
+                    BankBase* bank;
                     LoadFlags flags;
                     Asset* destHandle;
+                    Clock::time_point queuedAt;
 
                     void ExecuteRange(enki::TaskSetPartition range_, uint32_t threadnum_) override
                     {
-                        *destHandle = registry->LoadInternal(referencePath, flags);
+                        *destHandle = registry->LoadResolved(reference->identifierHash, bank, reference->path, flags, queuedAt);
                     }
                 };
 
@@ -202,30 +304,32 @@ namespace rn::asset
                 ScopedVector<enki::Dependency> taskDependencies(referenceCount);
                 ScopedVector<ResolveAssetDependencyTask> referenceTasks(referenceCount);
                 ScopedVector<Asset> dependentHandles(referenceCount);
-                ScopedVector<String> sanitizedReferenceStrings(referenceCount);
+                ScopedVector<BankBase*> dependentBanks(referenceCount);
 
                 HandleAssetLoadTask handleLoadTask;
                 handleLoadTask.registry = this;
                 handleLoadTask.bank = bank;
                 handleLoadTask.asset = &asset;
+                handleLoadTask.assetData = assetData.data;
+                handleLoadTask.assetDataMapping = assetDataMapping;
                 handleLoadTask.destHandle = handle.second;
-                handleLoadTask.identifier = identifier;
                 handleLoadTask.path = path;
                 handleLoadTask.dependencies = dependentHandles;
+                handleLoadTask.dependencyBanks = dependentBanks;
+                handleLoadTask.recordTelemetry = _telemetry != nullptr;
 
                 if (!asset.references.empty())
                 {
                     size_t dependencyIdx = 0;
-                    for (const std::string_view reference : asset.references)
+                    for (const schema::AssetReference& reference : asset.references)
                     {
-                        String& referencePath = sanitizedReferenceStrings[dependencyIdx];
-                        referencePath = { reference.data(), reference.length() };
-                        SanitizePath(referencePath);
+                        dependentBanks[dependencyIdx] = BankForExtensionHash(reference.extensionHash);
 
                         ResolveAssetDependencyTask& dependencyTask = referenceTasks[dependencyIdx];
                         dependencyTask.registry = this;
-                        dependencyTask.referencePath = referencePath;
-                        dependencyTask.flags = flags;
+                        dependencyTask.reference = &reference;
+                        dependencyTask.bank = dependentBanks[dependencyIdx];
+                        dependencyTask.flags = referenceFlags;
                         dependencyTask.destHandle = &dependentHandles[dependencyIdx];
 
                         handleLoadTask.SetDependency(taskDependencies[dependencyIdx], &dependencyTask);
@@ -234,6 +338,7 @@ namespace rn::asset
 
                     for (ResolveAssetDependencyTask& task : referenceTasks)
                     {
+                        task.queuedAt = fnNow();
                         scheduler->AddTaskSetToPipe(&task);
                     }
                 }
@@ -242,34 +347,918 @@ namespace rn::asset
                     scheduler->AddTaskSetToPipe(&handleLoadTask);
                 }
 
-                scheduler->WaitforTask(&handleLoadTask);
+                scheduler->WaitforTask(&handleLoadTask, LOAD_WAIT_PRIORITY);
                 while (handleLoadTask.doReschedule)
                 {
                     // Reschedule the task if not all of its dependencies were ready at time of load
                     handleLoadTask.doReschedule = false;
                     scheduler->AddTaskSetToPipe(&handleLoadTask);
-                    scheduler->WaitforTask(&handleLoadTask);
+                    scheduler->WaitforTask(&handleLoadTask, LOAD_WAIT_PRIORITY);
                 }
+
+                if (handleLoadTask.dependencyFailed)
+                {
+                    LogError(LogCategory::Asset, "Failed to load asset \"{}\", one of its references failed to load", path);
+                    FailLoad(bank, handle.second, dependentHandles);
+                    return handle.second;
+                }
+
+                // Includes the time spent waiting to be rescheduled
+                record.dependencyWaitUs = LoadTelemetry::ElapsedUs(deserializeEnd, handleLoadTask.buildStart);
+                record.buildUs = LoadTelemetry::ElapsedUs(handleLoadTask.buildStart, handleLoadTask.buildEnd);
             }
             else
             {
                 ScopedVector<Asset> dependencies;
                 dependencies.reserve(asset.references.size());
-                for (std::string_view reference : asset.references)
+                for (const schema::AssetReference& reference : asset.references)
                 {
-                    dependencies.push_back(LoadInternal(reference, flags));
+                    dependencies.push_back(LoadResolved(reference.identifierHash, BankForExtensionHash(reference.extensionHash), reference.path, referenceFlags));
                 }
-                
 
+                if (AnyLoadFailed(dependencies))
+                {
+                    LogError(LogCategory::Asset, "Failed to load asset \"{}\", one of its references failed to load", path);
+                    FailLoad(bank, handle.second, dependencies);
+                    return handle.second;
+                }
+
+                Clock::time_point buildStart = fnNow();
                 bank->Store(handle.second, {
-                    .identifier = identifier,
-                    .data = asset.assetData,
+                    .identifier = path,
+                    .data = assetData.data,
                     .dependencies = dependencies,
-                    .registry = this
+                    .registry = this,
+                    .mapping = assetDataMapping
                 });
+
+                record.dependencyWaitUs = LoadTelemetry::ElapsedUs(deserializeEnd, buildStart);
+                record.buildUs = LoadTelemetry::ElapsedUs(buildStart, fnNow());
+            }
+
+            if (_telemetry)
+            {
+                _telemetry->Record(std::move(record));
             }
         }
 
         return handle.second;
     }
-}
\ No newline at end of file
+
+    void Registry::FailLoad(BankBase* bank, Asset handle, Span<const Asset> dependencies)
+    {
+        for (Asset dependency : dependencies)
+        {
+            Release(dependency);
+        }
+
+        bank->FailLoad(handle);
+    }
+
+    bool Registry::AnyLoadFailed(Span<const Asset> assets) const
+    {
+        return std::any_of(assets.begin(), assets.end(), [this](Asset asset)
+        {
+            return BankForAsset(asset)->LoadFailed(asset);
+        });
+    }
+
+    struct Registry::BatchState
+    {
+        // Resolved by data_build, the path is only needed to map the file
+        struct Reference
+        {
+            StringHash identifierHash = 0;
+            BankBase* bank = nullptr;
+            String path;
+        };
+
+        struct Node
+        {
+            String path;
+            StringHash identifierHash = 0;
+            BankBase* bank = nullptr;
+            Asset handle = Asset::Invalid;
+            bool needsLoad = false;
+            bool deferred = false;
+            bool failed = false;
+
+            // The reference a deferred node is waiting on
+            Asset blockingDependency = Asset::Invalid;
+
+            // Nodes added ahead of time from the manifest hold a reference until a root or reference claims it
+            bool unclaimedReference = false;
+            uint32_t wave = 0;
+
+            // Filled in as the node gets mapped and built, when telemetry is enabled
+            AssetLoadRecord record;
+            LoadTelemetry::Clock::time_point mappedAt;
+
+            // Points into the mapping, except for the references which get copied out by the map pass
+            TrackedUniquePtr<MappedAsset> mapping;
+            schema::Asset asset;
+            Vector<Reference> references = MakeVector<Reference>(MemoryCategory::Asset);
+
+            // One entry per reference, in reference order
+            Vector<Asset> dependencies = MakeVector<Asset>(MemoryCategory::Asset);
+            Vector<uint32_t> dependencyNodes = MakeVector<uint32_t>(MemoryCategory::Asset);
+        };
+
+        struct ExecuteTask : enki::ITaskSet
+        {
+            Registry* registry = nullptr;
+            BatchState* batch = nullptr;
+
+            void ExecuteRange(enki::TaskSetPartition range_, uint32_t threadnum_) override
+            {
+                registry->ExecuteBatch(*batch);
+            }
+        };
+
+        std::pair<uint32_t, bool> FindOrAddNode(Registry* registry, std::string_view identifier)
+        {
+            String path = { identifier.data(), identifier.size() };
+            SanitizePath(path);
+
+            return FindOrAddNode(HashString(path), registry->BankForPath(path), path);
+        }
+
+        std::pair<uint32_t, bool> FindOrAddNode(StringHash identifierHash, BankBase* bank, std::string_view path, bool claimReference = true)
+        {
+            auto it = nodeLookup.find(identifierHash);
+            if (it != nodeLookup.end())
+            {
+                // Every root and every reference holds its own reference to the asset
+                Node& node = nodes[it->second];
+                if (node.unclaimedReference && claimReference)
+                {
+                    node.unclaimedReference = false;
+                }
+                else if (claimReference)
+                {
+                    node.bank->AddReference(node.handle);
+                }
+
+                return std::make_pair(it->second, false);
+            }
+
+            std::pair<bool, Asset> handle = bank->FindOrAllocateHandle(identifierHash);
+
+            uint32_t nodeIdx = uint32_t(nodes.size());
+            Node& node = nodes.emplace_back();
+            node.path = { path.data(), path.size() };
+            node.identifierHash = identifierHash;
+            node.bank = bank;
+            node.handle = handle.second;
+            node.unclaimedReference = !claimReference;
+
+            // Assets which already exist are either resident or being loaded by someone else, unless we're reloading
+            node.needsLoad = handle.first || TestFlag(flags, LoadFlags::Reload);
+
+            nodeLookup[identifierHash] = nodeIdx;
+            return std::make_pair(nodeIdx, true);
+        }
+
+        LoadFlags flags = LoadFlags::None;
+        LoadTelemetry::Clock::time_point queuedAt;
+        Vector<String> identifiers = MakeVector<String>(MemoryCategory::Asset);
+        Vector<Asset> assets = MakeVector<Asset>(MemoryCategory::Asset);
+        Vector<Node> nodes = MakeVector<Node>(MemoryCategory::Asset);
+        HashMap<StringHash, uint32_t> nodeLookup = MakeHashMap<StringHash, uint32_t>(MemoryCategory::Asset);
+        ExecuteTask task;
+    };
+
+    Batch Registry::LoadBatch(Span<const std::string_view> identifiers, LoadFlags flags)
+    {
+        BatchState* batch = TrackedNew<BatchState>(MemoryCategory::Asset);
+        batch->flags = flags;
+        batch->queuedAt = _telemetry ? LoadTelemetry::Clock::now() : LoadTelemetry::Clock::time_point();
+        batch->task.registry = this;
+        batch->task.batch = batch;
+
+        batch->identifiers.reserve(identifiers.size());
+        for (std::string_view identifier : identifiers)
+        {
+            batch->identifiers.emplace_back(identifier.data(), identifier.size());
+        }
+
+        Batch handle = _batches.Store(std::move(batch));
+        if (_enableMultithreadedLoad)
+        {
+            batch->task.m_Priority = BATCH_TASK_PRIORITY;
+            TaskScheduler()->AddTaskSetToPipe(&batch->task);
+        }
+        else
+        {
+            ExecuteBatch(*batch);
+        }
+
+        return handle;
+    }
+
+    BatchPlan Registry::PlanBatch(Span<const std::string_view> identifiers) const
+    {
+        BatchPlan plan;
+        if (!_manifest)
+        {
+            return plan;
+        }
+
+        MemoryScope SCOPE;
+        ScopedVector<uint32_t> entryIndices;
+
+        plan.complete = true;
+        for (std::string_view identifier : identifiers)
+        {
+            String path = { identifier.data(), identifier.size() };
+            SanitizePath(path);
+
+            const ManifestEntry* entry = _manifest->Find(HashString(path));
+            if (!entry)
+            {
+                plan.complete = false;
+                continue;
+            }
+
+            Span<const uint32_t> closure = _manifest->Closure(*entry);
+            entryIndices.insert(entryIndices.end(), closure.begin(), closure.end());
+        }
+
+        // Closures of different roots usually overlap
+        std::sort(entryIndices.begin(), entryIndices.end());
+        entryIndices.erase(std::unique(entryIndices.begin(), entryIndices.end()), entryIndices.end());
+
+        for (uint32_t entryIdx : entryIndices)
+        {
+            const ManifestEntry& entry = _manifest->Entry(entryIdx);
+            plan.fileSizeInBytes += entry.fileSizeInBytes;
+            plan.dataSizeInBytes += entry.dataSizeInBytes;
+        }
+
+        plan.assetCount = entryIndices.size();
+        return plan;
+    }
+
+    bool Registry::IsBatchComplete(Batch batch) const
+    {
+        BatchState* state = _batches.GetHot(batch);
+        return state->task.GetIsComplete();
+    }
+
+    void Registry::WaitForBatch(Batch batch) const
+    {
+        BatchState* state = _batches.GetHot(batch);
+        if (_enableMultithreadedLoad)
+        {
+            TaskScheduler()->WaitforTask(&state->task);
+        }
+    }
+
+    Span<const Asset> Registry::BatchAssets(Batch batch) const
+    {
+        BatchState* state = _batches.GetHot(batch);
+
+        // Batch assets are only available once the batch has completed
+        RN_ASSERT(state->task.GetIsComplete());
+        return state->assets;
+    }
+
+    void Registry::ReleaseBatch(Batch batch)
+    {
+        WaitForBatch(batch);
+
+        BatchState* state = _batches.GetHot(batch);
+        TrackedDelete(state);
+        _batches.Remove(batch);
+    }
+
+    void Registry::ExecuteBatch(BatchState& batch)
+    {
+        MemoryScope SCOPE;
+        using Node = BatchState::Node;
+
+        auto fnRunTask = [this](enki::ITaskSet& task)
+        {
+            if (task.m_SetSize == 0)
+            {
+                return;
+            }
+
+            if (_enableMultithreadedLoad)
+            {
+                enki::TaskScheduler* scheduler = TaskScheduler();
+                scheduler->AddTaskSetToPipe(&task);
+                scheduler->WaitforTask(&task, LOAD_WAIT_PRIORITY);
+            }
+            else
+            {
+                task.ExecuteRange({ 0, task.m_SetSize }, 0);
+            }
+        };
+
+        struct MapAssetsTask : enki::ITaskSet
+        {
+            Registry* registry = nullptr;
+            BatchState* batch = nullptr;
+            Span<const uint32_t> nodeIndices;
+
+            void ExecuteRange(enki::TaskSetPartition range_, uint32_t threadnum_) override
+            {
+                for (uint32_t i = range_.start; i < range_.end; ++i)
+                {
+                    MemoryScope SCOPE;
+                    Node& node = batch->nodes[nodeIndices[i]];
+
+                    String fullPath = registry->_contentPrefix;
+                    fullPath.append(node.path);
+
+                    LoadTelemetry* telemetry = registry->_telemetry.get();
+                    LoadTelemetry::Clock::time_point mapStart = telemetry ? LoadTelemetry::Clock::now() : LoadTelemetry::Clock::time_point();
+                    node.mapping = registry->_onMapAsset(fullPath);
+                    if (!node.mapping || !IsValidAssetFile(node.mapping->Ptr()))
+                    {
+                        LogError(LogCategory::Asset, "Failed to load asset \"{}\", the file is missing or not a valid asset file", node.path.c_str());
+                        node.mapping.reset();
+                        node.failed = true;
+                        node.bank->FailLoad(node.handle);
+                        continue;
+                    }
+
+                    if (telemetry)
+                    {
+                        node.mappedAt = LoadTelemetry::Clock::now();
+                        node.record.bytesRead = node.mapping->Ptr().size();
+                        node.record.queueLatencyUs = LoadTelemetry::ElapsedUs(batch->queuedAt, mapStart);
+                        node.record.mapUs = LoadTelemetry::ElapsedUs(mapStart, node.mappedAt);
+                    }
+
+                    auto fnAlloc = [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); };
+                    node.asset = DeserializeView<schema::Asset>(node.mapping->Ptr(), fnAlloc);
+
+                    if (registry->_enableHotReload)
+                    {
+                        registry->RecordHotReloadEntry(node.identifierHash, node.bank, node.path, node.asset.references);
+                    }
+
+                    node.references.reserve(node.asset.references.size());
+                    for (const schema::AssetReference& reference : node.asset.references)
+                    {
+                        node.references.push_back({
+                            .identifierHash = reference.identifierHash,
+                            .bank = registry->BankForExtensionHash(reference.extensionHash),
+                            .path = { reference.path.data(), reference.path.size() }
+                        });
+                    }
+
+                    // Allocated from this iteration's memory scope
+                    node.asset.references = {};
+                }
+            }
+        };
+
+        struct BuildAssetsTask : enki::ITaskSet
+        {
+            Registry* registry = nullptr;
+            BatchState* batch = nullptr;
+            Span<const uint32_t> nodeIndices;
+
+            void ExecuteRange(enki::TaskSetPartition range_, uint32_t threadnum_) override
+            {
+                for (uint32_t i = range_.start; i < range_.end; ++i)
+                {
+                    MemoryScope SCOPE;
+                    Node& node = batch->nodes[nodeIndices[i]];
+
+                    node.deferred = false;
+                    if (node.failed)
+                    {
+                        continue;
+                    }
+
+                    // Dependencies built by this batch are resident by the time their dependents' wave runs, unless they
+                    // failed to load. Dependencies loaded elsewhere might still be in flight, in which case we try again later.
+                    bool dependencyFailed = false;
+                    for (uint32_t dependencyIdx : node.dependencyNodes)
+                    {
+                        const Node& dependency = batch->nodes[dependencyIdx];
+                        if (dependency.bank->AssetResidency(dependency.handle) != Residency::Resident)
+                        {
+                            dependencyFailed = dependency.bank->LoadFailed(dependency.handle);
+                            node.deferred = !dependencyFailed;
+                            node.blockingDependency = dependency.handle;
+                            break;
+                        }
+                    }
+
+                    if (dependencyFailed)
+                    {
+                        LogError(LogCategory::Asset, "Failed to load asset \"{}\", one of its references failed to load", node.path.c_str());
+                        registry->FailLoad(node.bank, node.handle, node.dependencies);
+                        node.mapping.reset();
+                        node.failed = true;
+                        continue;
+                    }
+
+                    if (node.deferred)
+                    {
+                        continue;
+                    }
+
+                    // Dependency wait covers everything between the node being mapped and its wave being built
+                    LoadTelemetry* telemetry = registry->_telemetry.get();
+                    auto fnNow = [telemetry]() { return telemetry ? LoadTelemetry::Clock::now() : LoadTelemetry::Clock::time_point(); };
+                    LoadTelemetry::Clock::time_point deserializeStart = fnNow();
+
+                    const schema::Asset& asset = node.asset;
+
+                    // Owners are claimed right before being built. Sharers of an owner which is part of the same wave or of
+                    // another load become resident once it's built.
+                    const Asset contentOwner = node.bank->ShareContent(node.handle, { asset.contentHash.lower, asset.contentHash.upper });
+                    DecompressedAssetData assetData;
+                    if (contentOwner == node.handle && !DecompressAssetData(asset, registry->_enableMultithreadedLoad, assetData))
+                    {
+                        LogError(LogCategory::Asset, "Failed to load asset \"{}\", its payload is corrupt or couldn't be decompressed", node.path.c_str());
+                        registry->FailLoad(node.bank, node.handle, node.dependencies);
+                        node.mapping.reset();
+                        node.failed = true;
+                        continue;
+                    }
+                    LoadTelemetry::Clock::time_point buildStart = fnNow();
+
+                    if (contentOwner == node.handle)
+                    {
+                        node.bank->Store(node.handle, {
+                            .identifier = node.path,
+                            .data = assetData.data,
+                            .dependencies = node.dependencies,
+                            .registry = registry,
+                            .mapping = asset.compression == schema::AssetCompression::None ? &node.mapping : nullptr
+                        });
+                    }
+                    else
+                    {
+                        // Same content means the same references, which the owner holds on to already
+                        node.bank->StoreShared(node.handle, contentOwner);
+                        for (Asset dependency : node.dependencies)
+                        {
+                            registry->Release(dependency);
+                        }
+                    }
+
+                    node.mapping.reset();
+
+                    if (telemetry)
+                    {
+                        node.record.identifier = node.path;
+                        node.record.extensionHash = HashString(PathExtension(node.path));
+                        node.record.deserializeUs = LoadTelemetry::ElapsedUs(deserializeStart, buildStart);
+                        node.record.dependencyWaitUs = LoadTelemetry::ElapsedUs(node.mappedAt, deserializeStart);
+                        node.record.buildUs = LoadTelemetry::ElapsedUs(buildStart, fnNow());
+                        telemetry->Record(std::move(node.record));
+                    }
+                }
+            }
+        };
+
+        // Gather the union of the reference closures of all batch roots, breadth first.
+        // Every newly discovered asset in a level of the traversal gets mapped in parallel.
+        ScopedVector<uint32_t> nodesToMap;
+        batch.assets.reserve(batch.identifiers.size());
+        for (const String& identifier : batch.identifiers)
+        {
+            std::pair<uint32_t, bool> node = batch.FindOrAddNode(this, identifier);
+            if (node.second && batch.nodes[node.first].needsLoad)
+            {
+                nodesToMap.push_back(node.first);
+            }
+
+            batch.assets.push_back(batch.nodes[node.first].handle);
+        }
+
+        // The manifest knows the full reference closure of every root, so all of it can be mapped in a single pass.
+        // Anything missing from the manifest is discovered level by level from the mapped assets' references.
+        if (_manifest)
+        {
+            size_t rootNodeCount = batch.nodes.size();
+            for (size_t rootIdx = 0; rootIdx < rootNodeCount; ++rootIdx)
+            {
+                const ManifestEntry* rootEntry = batch.nodes[rootIdx].needsLoad ? _manifest->Find(batch.nodes[rootIdx].identifierHash) : nullptr;
+                if (!rootEntry)
+                {
+                    continue;
+                }
+
+                for (uint32_t entryIdx : _manifest->Closure(*rootEntry))
+                {
+                    const ManifestEntry& entry = _manifest->Entry(entryIdx);
+                    std::pair<uint32_t, bool> node = batch.FindOrAddNode(entry.identifierHash, BankForExtensionHash(entry.extensionHash), _manifest->Path(entry), false);
+                    if (node.second && batch.nodes[node.first].needsLoad)
+                    {
+                        nodesToMap.push_back(node.first);
+                    }
+                }
+            }
+        }
+
+        ScopedVector<uint32_t> nodesToBuild;
+        while (!nodesToMap.empty())
+        {
+            MapAssetsTask mapTask;
+            mapTask.registry = this;
+            mapTask.batch = &batch;
+            mapTask.nodeIndices = nodesToMap;
+            mapTask.m_SetSize = uint32_t(nodesToMap.size());
+            fnRunTask(mapTask);
+
+            ScopedVector<uint32_t> nextNodesToMap;
+            for (uint32_t nodeIdx : nodesToMap)
+            {
+                nodesToBuild.push_back(nodeIdx);
+
+                // Node references are invalidated when new nodes get added
+                size_t referenceCount = batch.nodes[nodeIdx].references.size();
+                for (size_t referenceIdx = 0; referenceIdx < referenceCount; ++referenceIdx)
+                {
+                    const BatchState::Reference& reference = batch.nodes[nodeIdx].references[referenceIdx];
+                    std::pair<uint32_t, bool> dependency = batch.FindOrAddNode(reference.identifierHash, reference.bank, reference.path);
+                    const Node& dependencyNode = batch.nodes[dependency.first];
+                    if (dependency.second && dependencyNode.needsLoad)
+                    {
+                        nextNodesToMap.push_back(dependency.first);
+                    }
+
+                    Node& node = batch.nodes[nodeIdx];
+                    node.dependencies.push_back(dependencyNode.handle);
+                    node.dependencyNodes.push_back(dependency.first);
+                }
+            }
+
+            nodesToMap = std::move(nextNodesToMap);
+        }
+
+        // Assign each node to a wave one past its deepest dependency which is being loaded by this batch
+        enum class VisitState : uint8_t
+        {
+            Unvisited,
+            Visiting,
+            Visited
+        };
+
+        ScopedVector<VisitState> visitStates(batch.nodes.size(), VisitState::Unvisited);
+        auto fnAssignWave = [&](uint32_t nodeIdx, auto& fnRecurse) -> uint32_t
+        {
+            Node& node = batch.nodes[nodeIdx];
+
+            // Circular asset references can't be resolved, the asset closing the cycle fails along with its dependents
+            if (visitStates[nodeIdx] == VisitState::Visiting)
+            {
+                if (!node.failed)
+                {
+                    LogError(LogCategory::Asset, "Failed to load asset \"{}\", it is part of a circular reference", node.path.c_str());
+                    FailLoad(node.bank, node.handle, node.dependencies);
+                    node.mapping.reset();
+                    node.failed = true;
+                }
+
+                return node.wave;
+            }
+
+            if (visitStates[nodeIdx] != VisitState::Visited)
+            {
+                visitStates[nodeIdx] = VisitState::Visiting;
+
+                uint32_t wave = 0;
+                for (uint32_t dependencyIdx : node.dependencyNodes)
+                {
+                    if (batch.nodes[dependencyIdx].needsLoad)
+                    {
+                        wave = std::max(wave, fnRecurse(dependencyIdx, fnRecurse) + 1);
+                    }
+                }
+
+                node.wave = wave;
+                visitStates[nodeIdx] = VisitState::Visited;
+            }
+
+            return node.wave;
+        };
+
+        for (uint32_t nodeIdx : nodesToBuild)
+        {
+            fnAssignWave(nodeIdx, fnAssignWave);
+        }
+
+        std::stable_sort(nodesToBuild.begin(), nodesToBuild.end(), [&batch](uint32_t lhs, uint32_t rhs)
+        {
+            return batch.nodes[lhs].wave < batch.nodes[rhs].wave;
+        });
+
+        LogInfo(LogCategory::Asset, "Loading batch of {} asset(s) with {} root(s)",
+            nodesToBuild.size(),
+            batch.identifiers.size());
+
+        // Build all assets in a wave in parallel before moving on to the next one. Nodes waiting on references loaded
+        // elsewhere are carried over into the following waves, so everything else gets built before waiting on those loads.
+        ScopedVector<uint32_t> deferredNodes;
+        auto waveBegin = nodesToBuild.begin();
+        while (waveBegin != nodesToBuild.end() || !deferredNodes.empty())
+        {
+            ScopedVector<uint32_t> waveNodes = std::move(deferredNodes);
+            if (waveBegin != nodesToBuild.end())
+            {
+                uint32_t wave = batch.nodes[*waveBegin].wave;
+                auto waveEnd = std::find_if(waveBegin, nodesToBuild.end(), [&batch, wave](uint32_t nodeIdx)
+                {
+                    return batch.nodes[nodeIdx].wave != wave;
+                });
+
+                waveNodes.insert(waveNodes.end(), waveBegin, waveEnd);
+                waveBegin = waveEnd;
+            }
+
+            // Read before building, so loads completing during the wave don't get missed
+            uint64_t completedLoadCount = CompletedLoadCount();
+
+            BuildAssetsTask buildTask;
+            buildTask.registry = this;
+            buildTask.batch = &batch;
+            buildTask.nodeIndices = waveNodes;
+            buildTask.m_SetSize = uint32_t(waveNodes.size());
+            fnRunTask(buildTask);
+
+            std::erase_if(waveNodes, [&batch](uint32_t nodeIdx)
+            {
+                return !batch.nodes[nodeIdx].deferred;
+            });
+
+            deferredNodes = std::move(waveNodes);
+            if (deferredNodes.empty() || waveBegin != nodesToBuild.end())
+            {
+                continue;
+            }
+
+            // Single threaded loads of references loaded outside of the batch can't make progress while we wait,
+            // the load is further up the call stack
+            if (!_enableMultithreadedLoad)
+            {
+                for (uint32_t nodeIdx : deferredNodes)
+                {
+                    Node& node = batch.nodes[nodeIdx];
+                    LogError(LogCategory::Asset, "Failed to load asset \"{}\", it can't wait on references loaded further up the call stack", node.path.c_str());
+                    FailLoad(node.bank, node.handle, node.dependencies);
+                    node.mapping.reset();
+                    node.failed = true;
+                }
+
+                break;
+            }
+
+            WaitForDeferredNodes(batch, deferredNodes, completedLoadCount);
+        }
+
+        // Resident assets' dependencies are part of the closure, but nothing in the batch references them directly.
+        // Assets which were loaded without being referenced mean the manifest is out of date.
+        for (const Node& node : batch.nodes)
+        {
+            if (node.unclaimedReference)
+            {
+                if (node.needsLoad)
+                {
+                    LogWarning(LogCategory::Asset, "Asset \"{}\" is part of a manifest closure, but isn't referenced", node.path.c_str());
+                }
+
+                node.bank->Release(node.handle);
+            }
+        }
+
+        // Only the resulting handles need to outlive the batch's execution
+        batch.nodes.clear();
+        batch.nodeLookup.clear();
+    }
+
+    void Registry::WaitForDeferredNodes(BatchState& batch, Span<const uint32_t> nodeIndices, uint64_t completedLoadCount)
+    {
+        MemoryScope SCOPE;
+        ScopedVector<uint32_t> cycleNodes;
+        {
+            std::unique_lock lock(_loadWaitMutex);
+            for (uint32_t nodeIdx : nodeIndices)
+            {
+                const BatchState::Node& node = batch.nodes[nodeIdx];
+                _loadWaits[uint64_t(node.handle)] = node.blockingDependency;
+            }
+
+            // Loads waiting on each other in a circle never complete. Whoever closes the circle fails, which in turn
+            // fails everything waiting on it.
+            for (uint32_t nodeIdx : nodeIndices)
+            {
+                const Asset handle = batch.nodes[nodeIdx].handle;
+                auto waitIt = _loadWaits.find(uint64_t(handle));
+                for (size_t step = 0; waitIt != _loadWaits.end() && step < _loadWaits.size(); ++step)
+                {
+                    if (waitIt->second == handle)
+                    {
+                        cycleNodes.push_back(nodeIdx);
+                        _loadWaits.erase(uint64_t(handle));
+                        break;
+                    }
+
+                    waitIt = _loadWaits.find(uint64_t(waitIt->second));
+                }
+            }
+
+            if (cycleNodes.empty())
+            {
+                _loadCompleted.wait(lock, [this, completedLoadCount]() { return _completedLoadCount != completedLoadCount; });
+            }
+
+            for (uint32_t nodeIdx : nodeIndices)
+            {
+                _loadWaits.erase(uint64_t(batch.nodes[nodeIdx].handle));
+            }
+        }
+
+        for (uint32_t nodeIdx : cycleNodes)
+        {
+            BatchState::Node& node = batch.nodes[nodeIdx];
+            LogError(LogCategory::Asset, "Failed to load asset \"{}\", it is part of a circular reference with assets loaded outside of the batch", node.path.c_str());
+            FailLoad(node.bank, node.handle, node.dependencies);
+            node.mapping.reset();
+            node.failed = true;
+        }
+    }
+
+    uint64_t Registry::CompletedLoadCount()
+    {
+        std::unique_lock lock(_loadWaitMutex);
+        return _completedLoadCount;
+    }
+
+    void Registry::NotifyLoadCompleted()
+    {
+        {
+            std::unique_lock lock(_loadWaitMutex);
+            ++_completedLoadCount;
+        }
+
+        _loadCompleted.notify_all();
+    }
+
+    void Registry::RecordHotReloadEntry(StringHash identifierHash, BankBase* bank, std::string_view path, Span<const schema::AssetReference> references)
+    {
+        std::unique_lock lock(_hotReloadMutex);
+        HotReloadEntry& entry = _hotReloadIndex[identifierHash];
+        entry.path = { path.data(), path.size() };
+        entry.bank = bank;
+
+        entry.references.clear();
+        for (const schema::AssetReference& reference : references)
+        {
+            entry.references.push_back(reference.identifierHash);
+        }
+    }
+
+    size_t Registry::ReloadChanged(Span<const std::string_view> identifiers)
+    {
+        // Hot reload needs to be enabled when creating the registry
+        RN_ASSERT(_enableHotReload);
+
+        MemoryScope SCOPE;
+
+        // Loads below add to the index, so work off a copy
+        HashMap<StringHash, HotReloadEntry> index = MakeHashMap<StringHash, HotReloadEntry>(MemoryCategory::Asset);
+        {
+            std::unique_lock lock(_hotReloadMutex);
+            index = _hotReloadIndex;
+        }
+
+        // Assets which were never loaded or have been evicted since are picked up by their next load.
+        // Files which got touched without their content changing don't need a rebuild either.
+        ScopedVector<StringHash> changed;
+        for (std::string_view identifier : identifiers)
+        {
+            String path = { identifier.data(), identifier.size() };
+            SanitizePath(path);
+
+            StringHash identifierHash = HashString(path);
+            auto entryIt = index.find(identifierHash);
+            if (entryIt == index.end())
+            {
+                continue;
+            }
+
+            BankBase* bank = entryIt->second.bank;
+            Asset handle = bank->FindResident(identifierHash);
+            if (handle == Asset::Invalid)
+            {
+                continue;
+            }
+
+            String fullPath = _contentPrefix;
+            fullPath.append(path);
+
+            // Only the content hash is needed to tell whether anything changed
+            TrackedUniquePtr<MappedAsset> mapping = _onMapAsset(fullPath);
+            if (!mapping || !IsValidAssetFile(mapping->Ptr()))
+            {
+                LogWarning(LogCategory::Asset, "Skipping hot reload of \"{}\", the file is missing or not a valid asset file", path.c_str());
+                continue;
+            }
+
+            const schema::ContentHash assetContentHash = schema::Asset::Accessor(mapping->Ptr()).contentHash();
+            const LargeHash contentHash = { assetContentHash.lower, assetContentHash.upper };
+            if (contentHash != LargeHash{ 0, 0 } && contentHash == bank->ContentHash(handle))
+            {
+                continue;
+            }
+
+            changed.push_back(identifierHash);
+        }
+
+        if (changed.empty())
+        {
+            return 0;
+        }
+
+        HashMap<StringHash, Vector<StringHash>> dependents = MakeHashMap<StringHash, Vector<StringHash>>(MemoryCategory::Asset);
+        for (const auto& it : index)
+        {
+            for (StringHash reference : it.second.references)
+            {
+                dependents[reference].push_back(it.first);
+            }
+        }
+
+        // Everything referencing a changed asset needs to be rebuilt against its new version. So do assets sharing its
+        // data, which may not share its content anymore.
+        HashSet<StringHash> affected = MakeHashSet<StringHash>(MemoryCategory::Asset);
+        ScopedVector<StringHash> toVisit(changed.begin(), changed.end());
+        Vector<StringHash> sharers = MakeVector<StringHash>(MemoryCategory::Asset);
+        while (!toVisit.empty())
+        {
+            StringHash identifierHash = toVisit.back();
+            toVisit.pop_back();
+            if (!affected.insert(identifierHash).second)
+            {
+                continue;
+            }
+
+            auto dependentsIt = dependents.find(identifierHash);
+            if (dependentsIt != dependents.end())
+            {
+                toVisit.insert(toVisit.end(), dependentsIt->second.begin(), dependentsIt->second.end());
+            }
+
+            auto entryIt = index.find(identifierHash);
+            if (entryIt != index.end())
+            {
+                sharers.clear();
+                Asset handle = entryIt->second.bank->FindResident(identifierHash);
+                entryIt->second.bank->CollectSharers(handle, sharers);
+                toVisit.insert(toVisit.end(), sharers.begin(), sharers.end());
+            }
+        }
+
+        // Rebuild dependencies before their dependents
+        ScopedVector<StringHash> order;
+        HashSet<StringHash> visited = MakeHashSet<StringHash>(MemoryCategory::Asset);
+        auto fnVisit = [&](StringHash identifierHash, auto& fnRecurse) -> void
+        {
+            if (!visited.insert(identifierHash).second)
+            {
+                return;
+            }
+
+            for (StringHash reference : index[identifierHash].references)
+            {
+                if (affected.contains(reference))
+                {
+                    fnRecurse(reference, fnRecurse);
+                }
+            }
+
+            order.push_back(identifierHash);
+        };
+
+        for (StringHash identifierHash : affected)
+        {
+            fnVisit(identifierHash, fnVisit);
+        }
+
+        size_t rebuildCount = 0;
+        for (StringHash identifierHash : order)
+        {
+            const HotReloadEntry& entry = index[identifierHash];
+            if (!entry.bank || entry.bank->FindResident(identifierHash) == Asset::Invalid)
+            {
+                continue;
+            }
+
+            Release(LoadResolved(identifierHash, entry.bank, entry.path, LoadFlags::ReloadShallow));
+            ++rebuildCount;
+        }
+
+        LogInfo(LogCategory::Asset, "Hot reload rebuilt {} asset(s) for {} changed file(s)", rebuildCount, changed.size());
+        return rebuildCount;
+    }
+}
@@ -0,0 +1,248 @@
+#include "asset/streaming.hpp"
+#include "path.hpp"
+
+#include <algorithm>
+
+namespace rn::asset
+{
+    namespace
+    {
+        constexpr const size_t LATENCY_SAMPLE_COUNT = 1024;
+    }
+
+    StreamingQueue::StreamingQueue(Registry* registry, const StreamingQueueDesc& desc)
+        : _registry(registry)
+        , _maxInFlightRequests(desc.maxInFlightRequests)
+        , _requests(MemoryCategory::Asset, 64)
+    {
+        RN_ASSERT(_maxInFlightRequests > 0);
+    }
+
+    StreamingQueue::~StreamingQueue()
+    {
+        for (StreamRequest request : _inFlight)
+        {
+            RequestState& state = _requests.GetHotMutable(request);
+            _registry->WaitForBatch(state.batch);
+            Retire(state);
+        }
+
+        for (const auto& it : _identifierToRequest)
+        {
+            RequestState& state = _requests.GetHotMutable(it.second);
+            if (state.asset != Asset::Invalid)
+            {
+                _registry->Release(state.asset);
+            }
+
+            _requests.Remove(it.second);
+        }
+    }
+
+    StreamRequest StreamingQueue::Request(std::string_view identifier, StreamPriority priority, float sortKey)
+    {
+        String path = { identifier.data(), identifier.size() };
+        SanitizePath(path);
+
+        StringHash identifierHash = HashString(path);
+        auto it = _identifierToRequest.find(identifierHash);
+        if (it != _identifierToRequest.end())
+        {
+            RequestState& state = _requests.GetHotMutable(it->second);
+            ++state.refCount;
+
+            if (priority < state.priority || (priority == state.priority && sortKey < state.sortKey))
+            {
+                state.priority = priority;
+                state.sortKey = sortKey;
+            }
+
+            return it->second;
+        }
+
+        StreamRequest request = _requests.Store({
+            .identifier = std::move(path),
+            .identifierHash = identifierHash,
+            .priority = priority,
+            .sortKey = sortKey,
+            .sequence = _nextSequence++,
+            .status = StreamStatus::Pending,
+            .refCount = 1,
+            .requestTime = Clock::now()
+        });
+
+        _identifierToRequest[identifierHash] = request;
+        _pending.push_back(request);
+
+        return request;
+    }
+
+    void StreamingQueue::Reprioritize(StreamRequest request, StreamPriority priority, float sortKey)
+    {
+        RequestState& state = _requests.GetHotMutable(request);
+        state.priority = priority;
+        state.sortKey = sortKey;
+    }
+
+    void StreamingQueue::Release(StreamRequest request)
+    {
+        RequestState& state = _requests.GetHotMutable(request);
+        RN_ASSERT(state.refCount > 0);
+
+        if (--state.refCount > 0)
+        {
+            return;
+        }
+
+        switch (state.status)
+        {
+        case StreamStatus::Pending:
+            // Never started, nothing to clean up
+            std::erase(_pending, request);
+            Destroy(request, state);
+            break;
+        case StreamStatus::Complete:
+            Destroy(request, state);
+            break;
+        default:
+            // In-flight requests are cleaned up once they complete, unless they get requested again in the meantime
+            break;
+        }
+    }
+
+    StreamStatus StreamingQueue::Status(StreamRequest request) const
+    {
+        return _requests.GetHot(request).status;
+    }
+
+    Asset StreamingQueue::Result(StreamRequest request) const
+    {
+        const RequestState& state = _requests.GetHot(request);
+
+        // Results are only available once the request has completed
+        RN_ASSERT(state.status == StreamStatus::Complete);
+        return state.asset;
+    }
+
+    void StreamingQueue::Update()
+    {
+        auto inFlightEnd = std::remove_if(_inFlight.begin(), _inFlight.end(), [this](StreamRequest request)
+        {
+            RequestState& state = _requests.GetHotMutable(request);
+            if (!_registry->IsBatchComplete(state.batch))
+            {
+                return false;
+            }
+
+            Retire(state);
+            if (state.refCount == 0)
+            {
+                Destroy(request, state);
+            }
+
+            return true;
+        });
+
+        _inFlight.erase(inFlightEnd, _inFlight.end());
+
+        if (_pending.empty() || _inFlight.size() >= _maxInFlightRequests)
+        {
+            return;
+        }
+
+        // Priorities and sort keys may have changed since the last update
+        size_t startCount = std::min(_pending.size(), _maxInFlightRequests - _inFlight.size());
+        auto fnMoreUrgent = [this](StreamRequest lhs, StreamRequest rhs)
+        {
+            const RequestState& lhsState = _requests.GetHot(lhs);
+            const RequestState& rhsState = _requests.GetHot(rhs);
+            if (lhsState.priority != rhsState.priority)
+            {
+                return lhsState.priority < rhsState.priority;
+            }
+
+            if (lhsState.sortKey != rhsState.sortKey)
+            {
+                return lhsState.sortKey < rhsState.sortKey;
+            }
+
+            return lhsState.sequence < rhsState.sequence;
+        };
+
+        std::partial_sort(_pending.begin(), _pending.begin() + startCount, _pending.end(), fnMoreUrgent);
+
+        for (size_t i = 0; i < startCount; ++i)
+        {
+            StreamRequest request = _pending[i];
+            RequestState& state = _requests.GetHotMutable(request);
+
+            std::string_view identifier = state.identifier;
+            state.status = StreamStatus::InFlight;
+            state.batch = _registry->LoadBatch({ &identifier, 1 });
+            _inFlight.push_back(request);
+        }
+
+        _pending.erase(_pending.begin(), _pending.begin() + startCount);
+    }
+
+    StreamLatencyStats StreamingQueue::LatencyStats(StreamPriority priority) const
+    {
+        const LatencySamples& latencies = _latencies[size_t(priority)];
+        if (latencies.samples.empty())
+        {
+            return {};
+        }
+
+        MemoryScope SCOPE;
+        ScopedVector<float> sorted(latencies.samples.begin(), latencies.samples.end());
+        std::sort(sorted.begin(), sorted.end());
+
+        auto fnPercentile = [&sorted](float percentile)
+        {
+            size_t idx = size_t(percentile * float(sorted.size() - 1) + 0.5f);
+            return sorted[idx];
+        };
+
+        return {
+            .sampleCount = sorted.size(),
+            .p50Ms = fnPercentile(0.5f),
+            .p90Ms = fnPercentile(0.9f),
+            .p99Ms = fnPercentile(0.99f),
+            .maxMs = sorted.back()
+        };
+    }
+
+    void StreamingQueue::Retire(RequestState& state)
+    {
+        state.asset = _registry->BatchAssets(state.batch)[0];
+        state.status = StreamStatus::Complete;
+
+        _registry->ReleaseBatch(state.batch);
+        state.batch = Batch::Invalid;
+
+        // Latencies are attributed to the priority the request had when it completed
+        float latencyMs = std::chrono::duration<float, std::milli>(Clock::now() - state.requestTime).count();
+
+        LatencySamples& latencies = _latencies[size_t(state.priority)];
+        if (latencies.samples.size() < LATENCY_SAMPLE_COUNT)
+        {
+            latencies.samples.push_back(latencyMs);
+        }
+        else
+        {
+            latencies.samples[latencies.next] = latencyMs;
+            latencies.next = (latencies.next + 1) % LATENCY_SAMPLE_COUNT;
+        }
+    }
+
+    void StreamingQueue::Destroy(StreamRequest request, RequestState& state)
+    {
+        if (state.asset != Asset::Invalid)
+        {
+            _registry->Release(state.asset);
+        }
+
+        _identifierToRequest.erase(state.identifierHash);
+        _requests.Remove(request);
+    }
+}
@@ -0,0 +1,197 @@
+#include "asset/telemetry.hpp"
+#include "path.hpp"
+
+#include <cstdio>
+
+namespace rn::asset
+{
+    namespace
+    {
+        void AppendValue(String& out, uint64_t value)
+        {
+            char buffer[24];
+            int length = std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+            out.append(buffer, size_t(length));
+        }
+
+        void AppendJSONString(String& out, std::string_view str)
+        {
+            out.push_back('"');
+            for (char c : str)
+            {
+                if (c == '"' || c == '\\')
+                {
+                    out.push_back('\\');
+                }
+
+                out.push_back(c);
+            }
+            out.push_back('"');
+        }
+
+        template <typename T>
+        void AppendJSONTimings(String& out, const T& timings)
+        {
+            out.append("\"bytesRead\": ");
+            AppendValue(out, timings.bytesRead);
+            out.append(", \"queueLatencyUs\": ");
+            AppendValue(out, timings.queueLatencyUs);
+            out.append(", \"mapUs\": ");
+            AppendValue(out, timings.mapUs);
+            out.append(", \"deserializeUs\": ");
+            AppendValue(out, timings.deserializeUs);
+            out.append(", \"dependencyWaitUs\": ");
+            AppendValue(out, timings.dependencyWaitUs);
+            out.append(", \"buildUs\": ");
+            AppendValue(out, timings.buildUs);
+        }
+
+        bool WriteStringToFile(const char* path, const String& str)
+        {
+            FILE* outFile = nullptr;
+            fopen_s(&outFile, path, "wb");
+            if (!outFile)
+            {
+                return false;
+            }
+
+            size_t writeSize = fwrite(str.data(), 1, str.size(), outFile);
+            fclose(outFile);
+
+            return writeSize == str.size();
+        }
+    }
+
+    uint64_t LoadTelemetry::ElapsedUs(Clock::time_point start, Clock::time_point end)
+    {
+        if (end <= start)
+        {
+            return 0;
+        }
+
+        return uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+    }
+
+    void LoadTelemetry::Record(AssetLoadRecord&& record)
+    {
+        std::unique_lock lock(_mutex);
+
+        // Aggregated as records come in, so the totals still cover records which got overwritten
+        auto it = _extensionHashToStats.find(record.extensionHash);
+        if (it == _extensionHashToStats.end())
+        {
+            std::string_view extension = PathExtension(record.identifier);
+
+            it = _extensionHashToStats.emplace(record.extensionHash, _typeStats.size()).first;
+            AssetTypeLoadStats& typeStats = _typeStats.emplace_back();
+            typeStats.extension = { extension.data(), extension.size() };
+            typeStats.extensionHash = record.extensionHash;
+        }
+
+        AssetTypeLoadStats& typeStats = _typeStats[it->second];
+        typeStats.loadCount++;
+        typeStats.bytesRead += record.bytesRead;
+        typeStats.queueLatencyUs += record.queueLatencyUs;
+        typeStats.mapUs += record.mapUs;
+        typeStats.deserializeUs += record.deserializeUs;
+        typeStats.dependencyWaitUs += record.dependencyWaitUs;
+        typeStats.buildUs += record.buildUs;
+
+        if (_records.size() < MAX_RECORD_COUNT)
+        {
+            _records.push_back(std::move(record));
+        }
+        else
+        {
+            _records[_nextRecord] = std::move(record);
+            _nextRecord = (_nextRecord + 1) % MAX_RECORD_COUNT;
+        }
+    }
+
+    void LoadTelemetry::Reset()
+    {
+        std::unique_lock lock(_mutex);
+        _records.clear();
+        _nextRecord = 0;
+        _typeStats.clear();
+        _extensionHashToStats.clear();
+    }
+
+    Vector<AssetLoadRecord> LoadTelemetry::Records() const
+    {
+        std::unique_lock lock(_mutex);
+
+        Vector<AssetLoadRecord> records = MakeVector<AssetLoadRecord>(MemoryCategory::Asset);
+        records.reserve(_records.size());
+        records.insert(records.end(), _records.begin() + _nextRecord, _records.end());
+        records.insert(records.end(), _records.begin(), _records.begin() + _nextRecord);
+        return records;
+    }
+
+    Vector<AssetTypeLoadStats> LoadTelemetry::TypeStats() const
+    {
+        std::unique_lock lock(_mutex);
+        return _typeStats;
+    }
+
+    String LoadTelemetry::ExportCSV() const
+    {
+        Vector<AssetLoadRecord> records = Records();
+
+        String out = "identifier,bytes_read,queue_latency_us,map_us,deserialize_us,dependency_wait_us,build_us\n";
+        for (const AssetLoadRecord& record : records)
+        {
+            // Sanitized identifiers are paths, they don't contain commas or quotes worth escaping
+            out.append(record.identifier);
+            for (uint64_t value : { record.bytesRead, record.queueLatencyUs, record.mapUs, record.deserializeUs, record.dependencyWaitUs, record.buildUs })
+            {
+                out.push_back(',');
+                AppendValue(out, value);
+            }
+            out.push_back('\n');
+        }
+
+        return out;
+    }
+
+    String LoadTelemetry::ExportJSON() const
+    {
+        Vector<AssetLoadRecord> records = Records();
+        Vector<AssetTypeLoadStats> typeStats = TypeStats();
+
+        String out = "{\n    \"assets\": [";
+        for (size_t i = 0; i < records.size(); ++i)
+        {
+            out.append(i == 0 ? "\n        { \"identifier\": " : ",\n        { \"identifier\": ");
+            AppendJSONString(out, records[i].identifier);
+            out.append(", ");
+            AppendJSONTimings(out, records[i]);
+            out.append(" }");
+        }
+
+        out.append("\n    ],\n    \"types\": [");
+        for (size_t i = 0; i < typeStats.size(); ++i)
+        {
+            out.append(i == 0 ? "\n        { \"extension\": " : ",\n        { \"extension\": ");
+            AppendJSONString(out, typeStats[i].extension);
+            out.append(", \"loadCount\": ");
+            AppendValue(out, typeStats[i].loadCount);
+            out.append(", ");
+            AppendJSONTimings(out, typeStats[i]);
+            out.append(" }");
+        }
+
+        out.append("\n    ]\n}\n");
+        return out;
+    }
+
+    bool LoadTelemetry::WriteCSV(const char* path) const
+    {
+        return WriteStringToFile(path, ExportCSV());
+    }
+
+    bool LoadTelemetry::WriteJSON(const char* path) const
+    {
+        return WriteStringToFile(path, ExportJSON());
+    }
+}
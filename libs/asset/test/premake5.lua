@@ -5,15 +5,30 @@ project "assetTests"
     cppdialect "C++20"
     flags { "FatalWarnings", "MultiProcessorCompile" }
 
+    codegenfiles {
+        "schema/**.lua"
+    }
+
+    codegentargets {
+        "cpp"
+    }
+
+    codegenimportdirs {
+        "schema",
+    }
+
     files {
         "src/**.hpp",
         "src/**.cpp",
         "../../../libs/test/src/test_main.cpp",
+        PROJECT_ROOT .. "/build/codegen/assetTests/**.hpp",
+        PROJECT_ROOT .. "/build/codegen/assetTests/**.cpp",
     }
 
     includedirs(RN_COMMON_INCLUDES)
     includedirs(RN_ASSET_INCLUDES)
     includedirs(RN_GTEST_INCLUDES)
+    includedirs { PROJECT_ROOT .. "/build/codegen/assetTests" }
 
     libdirs {
         "%{wks.location}/%{cfg.buildcfg}"
@@ -21,4 +36,4 @@ project "assetTests"
 
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
 
-    links { "googletest", "rnCommon", "rnAsset"}
\ No newline at end of file
+    links { "googletest", "rnCommon", "rnAsset", "lz4", "zstd"}
\ No newline at end of file
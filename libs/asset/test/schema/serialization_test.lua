@@ -0,0 +1,15 @@
+namespace "rn.asset.test.schema"
+
+-- Covers luagen features the asset schemas don't use themselves
+
+Light = struct {
+    field(float, "radius"),
+    field(uint32, "color"),
+    field(uint16, "flags")
+}
+
+Scene = struct {
+    field(String, "name"),
+    field(soa(span(Light)), "lights"),
+    field(soa(span(Light)), "shadowedLights", { align = 32 })
+}
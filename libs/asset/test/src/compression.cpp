@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include "common/memory/memory.hpp"
+#include "common/memory/vector.hpp"
+#include "asset/compression.hpp"
+#include "luagen/schema.hpp"
+
+using namespace rn;
+
+namespace
+{
+    Vector<uint8_t> MakeCompressibleData(size_t size)
+    {
+        Vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            data[i] = uint8_t(i / 1024);
+        }
+
+        return data;
+    }
+
+    void TestRoundTrip(asset::schema::AssetCompression compression)
+    {
+        MemoryScope SCOPE;
+
+        // Spans multiple chunks, with a partial last chunk
+        Vector<uint8_t> data = MakeCompressibleData(asset::COMPRESSION_CHUNK_SIZE * 3 + 1234);
+        asset::CompressedAssetData compressed = asset::CompressAssetData(data, compression);
+
+        EXPECT_EQ(compressed.compression, compression);
+        EXPECT_EQ(compressed.chunks.size(), 4);
+        EXPECT_LT(compressed.data.size(), data.size());
+
+        asset::schema::Asset preSerialization = {
+            .identifier = "test",
+            .compression = compressed.compression,
+            .chunks = compressed.chunks,
+            .assetData = compressed.data
+        };
+
+        uint64_t destSize = asset::schema::Asset::SerializedSize(preSerialization);
+        Span<uint8_t> destSpan = { static_cast<uint8_t*>(ScopedAlloc(destSize, 64)), destSize };
+        rn::Serialize<asset::schema::Asset>(destSpan, preSerialization);
+
+        asset::schema::Asset postSerialization = rn::Deserialize<asset::schema::Asset>(destSpan, [](size_t size) { return ScopedAlloc(size, 64); });
+        asset::DecompressedAssetData decompressed;
+        ASSERT_TRUE(asset::DecompressAssetData(postSerialization, false, decompressed));
+
+        ASSERT_EQ(decompressed.data.size(), data.size());
+        EXPECT_TRUE(std::memcmp(decompressed.data.data(), data.data(), data.size()) == 0);
+    }
+}
+
+TEST(CompressionTests, CanRoundTripLZ4)
+{
+    TestRoundTrip(asset::schema::AssetCompression::LZ4);
+}
+
+TEST(CompressionTests, CanRoundTripZstd)
+{
+    TestRoundTrip(asset::schema::AssetCompression::Zstd);
+}
+
+TEST(CompressionTests, StoresIncompressibleDataUncompressed)
+{
+    MemoryScope SCOPE;
+
+    uint8_t data[] = { 0xFF, 0xAB, 0xBA, 0xDD };
+    asset::CompressedAssetData compressed = asset::CompressAssetData(data, asset::schema::AssetCompression::Zstd);
+
+    EXPECT_EQ(compressed.compression, asset::schema::AssetCompression::None);
+    EXPECT_TRUE(compressed.chunks.empty());
+    EXPECT_EQ(compressed.data.data(), data);
+    EXPECT_FALSE(compressed.storage);
+}
+
+TEST(CompressionTests, RejectsCorruptPayloads)
+{
+    MemoryScope SCOPE;
+
+    Vector<uint8_t> data = MakeCompressibleData(asset::COMPRESSION_CHUNK_SIZE * 2);
+    asset::CompressedAssetData compressed = asset::CompressAssetData(data, asset::schema::AssetCompression::LZ4);
+    ASSERT_EQ(compressed.chunks.size(), 2);
+
+    asset::schema::Asset asset = {
+        .identifier = "test",
+        .compression = compressed.compression,
+        .chunks = compressed.chunks,
+        .assetData = compressed.data
+    };
+
+    // Truncated payload, the last chunk runs past its end
+    asset::DecompressedAssetData decompressed;
+    asset.assetData = compressed.data.subspan(0, compressed.data.size() - 1);
+    EXPECT_FALSE(asset::DecompressAssetData(asset, false, decompressed));
+
+    // Chunks which don't decompress to their recorded size
+    asset.assetData = compressed.data;
+    compressed.chunks[1].uncompressedSize -= 1;
+    EXPECT_FALSE(asset::DecompressAssetData(asset, false, decompressed));
+    compressed.chunks[1].uncompressedSize += 1;
+
+    // Garbage in place of compressed data
+    std::memset(compressed.data.data(), 0xFF, compressed.chunks[0].compressedSize);
+    EXPECT_FALSE(asset::DecompressAssetData(asset, false, decompressed));
+}
+
+TEST(CompressionTests, DeserializesPayloadInPlace)
+{
+    MemoryScope SCOPE;
+
+    asset::schema::AssetReference references[] = {
+        { .identifierHash = 0x1234, .extensionHash = 0xABCD, .path = "reference.texture" }
+    };
+
+    uint8_t data[] = { 0xFF, 0xAB, 0xBA, 0xDD };
+    asset::schema::Asset preSerialization = {
+        .identifier = ".test",
+        .references = references,
+        .assetData = data
+    };
+
+    uint64_t destSize = asset::schema::Asset::SerializedSize(preSerialization);
+    Span<uint8_t> destSpan = { static_cast<uint8_t*>(ScopedAlloc(destSize, 64)), destSize };
+    rn::Serialize<asset::schema::Asset>(destSpan, preSerialization);
+
+    auto fnAlloc = [](size_t size) { return ScopedAlloc(size, 64); };
+    asset::schema::Asset copied = rn::Deserialize<asset::schema::Asset>(destSpan, fnAlloc);
+    asset::schema::Asset inPlace = rn::DeserializeView<asset::schema::Asset>(destSpan, fnAlloc);
+
+    EXPECT_EQ(inPlace.identifier, copied.identifier);
+    ASSERT_EQ(inPlace.references.size(), copied.references.size());
+    EXPECT_EQ(inPlace.references[0].path, copied.references[0].path);
+    EXPECT_EQ(inPlace.compression, copied.compression);
+
+    // The payload is the tail of the serialized asset
+    ASSERT_EQ(inPlace.assetData.size(), sizeof(data));
+    EXPECT_EQ(inPlace.assetData.data(), destSpan.data() + destSize - sizeof(data));
+    EXPECT_TRUE(std::memcmp(inPlace.assetData.data(), data, sizeof(data)) == 0);
+}
+
+TEST(CompressionTests, ValidatesAssetFiles)
+{
+    MemoryScope SCOPE;
+
+    uint8_t data[] = { 0xFF, 0xAB, 0xBA, 0xDD };
+    asset::schema::Asset preSerialization = {
+        .identifier = ".test",
+        .assetData = data
+    };
+
+    uint64_t destSize = asset::schema::Asset::SerializedSize(preSerialization);
+    Span<uint8_t> destSpan = { static_cast<uint8_t*>(ScopedAlloc(destSize, 64)), destSize };
+    rn::Serialize<asset::schema::Asset>(destSpan, preSerialization);
+
+    EXPECT_TRUE(asset::IsValidAssetFile(destSpan));
+    EXPECT_EQ(asset::schema::Asset::Accessor(destSpan).identifier(), ".test");
+
+    // Truncated inside the offset table
+    EXPECT_FALSE(asset::IsValidAssetFile(destSpan.subspan(0, 5 * SERIALIZED_FIELD_OFFSET_SIZE)));
+
+    // Truncated inside the identifier
+    EXPECT_FALSE(asset::IsValidAssetFile(destSpan.subspan(0, 6 * SERIALIZED_FIELD_OFFSET_SIZE + 2)));
+
+    // Text files, like the dependency files data_build keeps next to built assets
+    const char text[] = "[dependencies]\nfiles = [ \"textures/texture.png\", \"textures/texture.usda\" ]\n";
+    EXPECT_FALSE(asset::IsValidAssetFile({ reinterpret_cast<const uint8_t*>(text), sizeof(text) }));
+
+    // Assets written before the offset table started with their identifier
+    uint8_t oldLayout[64] = {};
+    const uint64_t identifierLength = 5;
+    std::memcpy(oldLayout, &identifierLength, sizeof(identifierLength));
+    std::memcpy(oldLayout + sizeof(identifierLength), ".test", identifierLength);
+    EXPECT_FALSE(asset::IsValidAssetFile(oldLayout));
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include "asset/content_watcher.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+
+using namespace rn;
+
+namespace
+{
+    using Clock = asset::ContentWatcher::Clock;
+
+    constexpr Clock::duration SETTLE_TIME = std::chrono::milliseconds(50);
+    constexpr Clock::duration POLL_TIMEOUT = std::chrono::seconds(5);
+
+    void WriteTestFile(const std::filesystem::path& path, const char* mode)
+    {
+        FILE* file = std::fopen(path.string().c_str(), mode);
+        std::fputs("content", file);
+        std::fclose(file);
+    }
+
+    // Copies the changes out, the views only last until the next poll. Parent directories may be reported along with files.
+    Vector<String> PollUntilChanged(asset::ContentWatcher& watcher, std::string_view path)
+    {
+        Vector<String> changes;
+        Clock::time_point deadline = Clock::now() + POLL_TIMEOUT;
+        while (std::find(changes.begin(), changes.end(), path) == changes.end() && Clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            for (std::string_view change : watcher.PollChanges())
+            {
+                changes.emplace_back(change);
+            }
+        }
+
+        return changes;
+    }
+}
+
+TEST(ContentWatcherTests, ReportsSettledWritesAndRenames)
+{
+    std::filesystem::path rootDir = std::filesystem::temp_directory_path() / "rn_content_watcher_test";
+    std::filesystem::path contentDir = rootDir / "content";
+    std::filesystem::remove_all(rootDir);
+    std::filesystem::create_directories(contentDir / "textures");
+
+    {
+        asset::ContentWatcher watcher(contentDir.string().c_str(), SETTLE_TIME);
+        ASSERT_TRUE(watcher.IsValid());
+        EXPECT_TRUE(watcher.PollChanges().empty());
+
+        // Several writes to the same file are reported once, after the last one settled
+        Clock::time_point writeTime = Clock::now();
+        WriteTestFile(contentDir / "textures" / "written.texture", "wb");
+        WriteTestFile(contentDir / "textures" / "written.texture", "ab");
+        EXPECT_TRUE(watcher.PollChanges().empty());
+
+        Vector<String> changes = PollUntilChanged(watcher, "textures/written.texture");
+        EXPECT_GE(Clock::now() - writeTime, SETTLE_TIME);
+        EXPECT_EQ(std::count(changes.begin(), changes.end(), "textures/written.texture"), 1);
+
+        // Files written elsewhere and moved into place show up under their new name
+        WriteTestFile(rootDir / "renamed.tmp", "wb");
+        std::filesystem::rename(rootDir / "renamed.tmp", contentDir / "renamed.material");
+        EXPECT_TRUE(watcher.PollChanges().empty());
+
+        changes = PollUntilChanged(watcher, "renamed.material");
+        EXPECT_EQ(std::count(changes.begin(), changes.end(), "renamed.material"), 1);
+        EXPECT_EQ(std::find(changes.begin(), changes.end(), "renamed.tmp"), changes.end());
+
+        // Reported changes don't come back
+        std::this_thread::sleep_for(2 * SETTLE_TIME);
+        EXPECT_TRUE(watcher.PollChanges().empty());
+    }
+
+    std::filesystem::remove_all(rootDir);
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include "asset/registry.hpp"
+
+#include <cstdio>
+
+using namespace rn;
+
+namespace
+{
+    Vector<uint8_t> WriteTestFile(const char* path, size_t size)
+    {
+        Vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            data[i] = uint8_t(i * 31);
+        }
+
+        FILE* file = std::fopen(path, "wb");
+        std::fwrite(data.data(), 1, data.size(), file);
+        std::fclose(file);
+
+        return data;
+    }
+
+    void TestFileBackend(asset::FnMapAsset fnMapAsset, const char* path, size_t size)
+    {
+        Vector<uint8_t> data = WriteTestFile(path, size);
+
+        {
+            TrackedUniquePtr<asset::MappedAsset> mapping = fnMapAsset(path);
+            Span<const uint8_t> mappedData = mapping->Ptr();
+
+            ASSERT_EQ(mappedData.size(), data.size());
+            EXPECT_TRUE(std::memcmp(mappedData.data(), data.data(), data.size()) == 0);
+        }
+
+        std::remove(path);
+    }
+}
+
+TEST(FileBackendTests, CanMapFilePrefetched)
+{
+    TestFileBackend(asset::MapFileAssetPrefetched, "test_file_prefetched.bin", 64 * 1024 + 17);
+}
+
+TEST(FileBackendTests, CanReadFileUnbuffered)
+{
+    // Several read requests, with an unaligned tail
+    TestFileBackend(asset::ReadFileAsset, "test_file_unbuffered.bin", 3 * 1024 * 1024 + 4095);
+    TestFileBackend(asset::ReadFileAsset, "test_file_unbuffered_small.bin", 17);
+}
@@ -0,0 +1,242 @@
+#include <gtest/gtest.h>
+#include "asset/manifest.hpp"
+
+#include "asset_gen.hpp"
+#include "luagen/schema.hpp"
+
+using namespace rn;
+
+RN_DEFINE_HANDLE(ManifestHandle, 0x92);
+struct ManifestType
+{
+    uint32_t data;
+};
+
+namespace
+{
+    class ManifestAssetBuilder : public asset::Builder<ManifestHandle, ManifestType>
+    {
+    public:
+
+        ManifestType Build(const asset::AssetBuildDesc& desc) override
+        {
+            RN_ASSERT(desc.data.size() == sizeof(ManifestType));
+            return *reinterpret_cast<const ManifestType*>(desc.data.data());
+        }
+
+        void Destroy(ManifestType& data) override {}
+        void Finalize() override {}
+        size_t MemoryFootprint(const ManifestType& data) override { return sizeof(ManifestType); }
+    };
+
+    // root.manifested -> mid.manifested -> leaf.manifested, root.manifested -> leaf.manifested
+    struct TestAsset
+    {
+        std::string_view path;
+        uint32_t value;
+        std::string_view references[2];
+    };
+
+    constexpr const TestAsset TEST_ASSETS[] = {
+        { "leaf.manifested", 1, {} },
+        { "mid.manifested", 2, { "leaf.manifested" } },
+        { "root.manifested", 3, { "mid.manifested", "leaf.manifested" } },
+    };
+
+    Vector<uint8_t> SerializeManifestedAsset(const TestAsset& testAsset)
+    {
+        Vector<asset::schema::AssetReference> references;
+        for (std::string_view reference : testAsset.references)
+        {
+            if (!reference.empty())
+            {
+                references.push_back({
+                    .identifierHash = HashString(reference),
+                    .extensionHash = HashString(".manifested"),
+                    .path = reference
+                });
+            }
+        }
+
+        ManifestType data = {
+            .data = testAsset.value
+        };
+
+        asset::schema::Asset asset = {
+            .identifier = ".manifested",
+            .references = references,
+            .assetData = { reinterpret_cast<uint8_t*>(&data), sizeof(data) }
+        };
+
+        Vector<uint8_t> out(asset::schema::Asset::SerializedSize(asset));
+        rn::Serialize<asset::schema::Asset>(out, asset);
+        return out;
+    }
+
+    // Matches what data_build writes for TEST_ASSETS
+    Vector<uint8_t> SerializeManifest()
+    {
+        Vector<asset::ManifestEntry> entries;
+        Vector<uint32_t> closures[std::size(TEST_ASSETS)];
+        for (const TestAsset& testAsset : TEST_ASSETS)
+        {
+            entries.push_back({
+                .identifierHash = HashString(testAsset.path),
+                .extensionHash = HashString(".manifested"),
+                .fileSizeInBytes = SerializeManifestedAsset(testAsset).size(),
+                .dataSizeInBytes = sizeof(ManifestType)
+            });
+        }
+
+        // Entry indices in TEST_ASSETS order, dependencies first
+        closures[0] = { 0 };
+        closures[1] = { 0, 1 };
+        closures[2] = { 0, 1, 2 };
+
+        Vector<size_t> order = { 0, 1, 2 };
+        std::sort(order.begin(), order.end(), [&entries](size_t lhs, size_t rhs)
+        {
+            return entries[lhs].identifierHash < entries[rhs].identifierHash;
+        });
+
+        Vector<uint32_t> sortedIdx(order.size());
+        for (uint32_t i = 0; i < order.size(); ++i)
+        {
+            sortedIdx[order[i]] = i;
+        }
+
+        Vector<asset::ManifestEntry> sortedEntries;
+        Vector<uint32_t> closureIndices;
+        String paths;
+        for (size_t idx : order)
+        {
+            asset::ManifestEntry entry = entries[idx];
+            entry.pathOffset = uint32_t(paths.size());
+            entry.pathLength = uint32_t(TEST_ASSETS[idx].path.size());
+            entry.closureOffset = uint32_t(closureIndices.size());
+            entry.closureCount = uint32_t(closures[idx].size());
+            for (uint32_t closureIdx : closures[idx])
+            {
+                closureIndices.push_back(sortedIdx[closureIdx]);
+            }
+
+            paths.append(TEST_ASSETS[idx].path);
+            sortedEntries.push_back(entry);
+        }
+
+        asset::ManifestHeader header = {
+            .magic = asset::MANIFEST_MAGIC,
+            .version = asset::MANIFEST_VERSION,
+            .entryCount = sortedEntries.size(),
+            .closureIndexCount = closureIndices.size(),
+            .pathSizeInBytes = paths.size()
+        };
+
+        Vector<uint8_t> out;
+        auto fnAppend = [&out](const void* data, size_t size)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        };
+
+        fnAppend(&header, sizeof(header));
+        fnAppend(sortedEntries.data(), sortedEntries.size() * sizeof(asset::ManifestEntry));
+        fnAppend(closureIndices.data(), closureIndices.size() * sizeof(uint32_t));
+        fnAppend(paths.data(), paths.size());
+        return out;
+    }
+
+    class MappedManifestTestData : public asset::MappedAsset
+    {
+    public:
+        MappedManifestTestData(const String& path)
+        {
+            if (path == "content.manifest")
+            {
+                _data = SerializeManifest();
+            }
+
+            for (const TestAsset& testAsset : TEST_ASSETS)
+            {
+                if (path == testAsset.path)
+                {
+                    _data = SerializeManifestedAsset(testAsset);
+                }
+            }
+        }
+
+        Span<const uint8_t> Ptr() const override
+        {
+            return _data;
+        }
+
+        Vector<uint8_t> _data;
+    };
+
+    TrackedUniquePtr<asset::MappedAsset> MapManifestTestData(const String& path)
+    {
+        return TrackedUniquePtr<asset::MappedAsset>(TrackedNew<MappedManifestTestData>(asset::MemoryCategory::Asset, path));
+    }
+}
+
+TEST(ManifestTests, CanFindClosures)
+{
+    asset::Manifest manifest("content.manifest", MapManifestTestData);
+    EXPECT_TRUE(manifest.IsValid());
+    EXPECT_EQ(manifest.Find(HashString("missing.manifested")), nullptr);
+
+    const asset::ManifestEntry* root = manifest.Find(HashString("root.manifested"));
+    ASSERT_NE(root, nullptr);
+    EXPECT_EQ(manifest.Path(*root), "root.manifested");
+
+    // Dependencies come before their dependents
+    Span<const uint32_t> closure = manifest.Closure(*root);
+    ASSERT_EQ(closure.size(), 3);
+    EXPECT_EQ(manifest.Path(manifest.Entry(closure[0])), "leaf.manifested");
+    EXPECT_EQ(manifest.Path(manifest.Entry(closure[1])), "mid.manifested");
+    EXPECT_EQ(manifest.Path(manifest.Entry(closure[2])), "root.manifested");
+}
+
+TEST(ManifestTests, CanPlanAndLoadBatch)
+{
+    asset::Manifest manifest("content.manifest", MapManifestTestData);
+    ManifestAssetBuilder builder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapManifestTestData,
+        .manifest = &manifest
+    });
+
+    registry.RegisterAssetType<ManifestHandle, ManifestType>({
+        .identifierHash = HashString(".manifested"),
+        .initialCapacity = 16,
+        .builder = &builder
+    });
+
+    std::string_view identifiers[] = { "Root.manifested", "mid.manifested" };
+
+    // Shared dependencies are only accounted for once
+    asset::BatchPlan plan = registry.PlanBatch(identifiers);
+    EXPECT_TRUE(plan.complete);
+    EXPECT_EQ(plan.assetCount, 3);
+    EXPECT_EQ(plan.dataSizeInBytes, 3 * sizeof(ManifestType));
+
+    asset::Batch batch = registry.LoadBatch(identifiers);
+    registry.WaitForBatch(batch);
+
+    Span<const asset::Asset> assets = registry.BatchAssets(batch);
+    ASSERT_EQ(assets.size(), 2);
+    const ManifestType* rootData = registry.Resolve<ManifestHandle, ManifestType>(ManifestHandle(assets[0]));
+    const ManifestType* midData = registry.Resolve<ManifestHandle, ManifestType>(ManifestHandle(assets[1]));
+    EXPECT_EQ(rootData->data, 3);
+    EXPECT_EQ(midData->data, 2);
+    EXPECT_EQ(registry.BankStats<ManifestHandle>().residentCount, 3);
+
+    // Nodes added from the manifest hold exactly one reference per root and per reference
+    registry.Release(assets[0]);
+    registry.Release(assets[1]);
+    registry.ReleaseBatch(batch);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<ManifestHandle>().residentCount, 0);
+}
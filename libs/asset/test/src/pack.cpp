@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include "asset/pack.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace rn;
+
+namespace
+{
+    struct TestPackBlob
+    {
+        std::string_view identifier;
+        uint32_t value;
+    };
+
+    void WriteTestPack(const char* path, Span<const TestPackBlob> blobs)
+    {
+        Vector<asset::PackEntry> toc;
+        uint64_t offset = AlignSize(sizeof(asset::PackHeader) + blobs.size() * sizeof(asset::PackEntry), asset::PACK_BLOB_ALIGNMENT);
+        for (const TestPackBlob& blob : blobs)
+        {
+            toc.push_back({
+                .identifierHash = HashString(blob.identifier),
+                .offsetInBytes = offset,
+                .sizeInBytes = sizeof(blob.value)
+            });
+
+            offset = AlignSize(offset + sizeof(blob.value), asset::PACK_BLOB_ALIGNMENT);
+        }
+
+        Vector<uint8_t> packData(offset);
+        for (size_t i = 0; i < blobs.size(); ++i)
+        {
+            std::memcpy(packData.data() + toc[i].offsetInBytes, &blobs[i].value, sizeof(blobs[i].value));
+        }
+
+        std::sort(toc.begin(), toc.end(), [](const asset::PackEntry& lhs, const asset::PackEntry& rhs)
+        {
+            return lhs.identifierHash < rhs.identifierHash;
+        });
+
+        asset::PackHeader header = {
+            .magic = asset::PACK_MAGIC,
+            .version = asset::PACK_VERSION,
+            .entryCount = toc.size(),
+            .blobAlignment = asset::PACK_BLOB_ALIGNMENT
+        };
+
+        std::memcpy(packData.data(), &header, sizeof(header));
+        std::memcpy(packData.data() + sizeof(header), toc.data(), toc.size() * sizeof(asset::PackEntry));
+
+        FILE* file = std::fopen(path, "wb");
+        std::fwrite(packData.data(), 1, packData.size(), file);
+        std::fclose(file);
+    }
+}
+
+TEST(PackTests, CanFindAssetsInPack)
+{
+    const TestPackBlob blobs[] = {
+        { .identifier = "textures/a.texture", .value = 0xDEADBEEF },
+        { .identifier = "textures/b.texture", .value = 0xDABABADA },
+        { .identifier = "geometry/c.geometry", .value = 0xCAFECAFE },
+    };
+
+    WriteTestPack("test_pack_find.pack", blobs);
+
+    {
+        asset::Pack pack("test_pack_find.pack");
+        EXPECT_TRUE(pack.IsValid());
+
+        for (const TestPackBlob& blob : blobs)
+        {
+            Span<const uint8_t> data = pack.Find(HashString(blob.identifier));
+            EXPECT_EQ(data.size(), sizeof(blob.value));
+            EXPECT_EQ(uintptr_t(data.data()) % asset::PACK_BLOB_ALIGNMENT, 0);
+            EXPECT_EQ(*reinterpret_cast<const uint32_t*>(data.data()), blob.value);
+        }
+
+        EXPECT_TRUE(pack.Find(HashString("textures/d.texture")).empty());
+    }
+
+    std::remove("test_pack_find.pack");
+}
+
+TEST(PackTests, CanMapAssetsFromMountedPack)
+{
+    const TestPackBlob blobs[] = {
+        { .identifier = "textures/a.texture", .value = 0xDEADBEEF },
+    };
+
+    WriteTestPack("test_pack_mount.pack", blobs);
+    EXPECT_TRUE(asset::MountPack("test_pack_mount.pack", "Content/"));
+
+    {
+        TrackedUniquePtr<asset::MappedAsset> mapping = asset::MapPackedAsset("content/textures/a.texture");
+        Span<const uint8_t> data = mapping->Ptr();
+        EXPECT_EQ(data.size(), sizeof(uint32_t));
+        EXPECT_EQ(*reinterpret_cast<const uint32_t*>(data.data()), 0xDEADBEEF);
+    }
+
+    asset::UnmountPacks();
+    std::remove("test_pack_mount.pack");
+}
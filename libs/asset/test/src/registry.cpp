@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include "asset/registry.hpp"
+#include "asset/compression.hpp"
 
 #include "asset_gen.hpp"
 #include "luagen/schema.hpp"
@@ -25,16 +26,17 @@ public:
 
     void Destroy(TestType& data) override {}
     void Finalize() override {}
+    size_t MemoryFootprint(const TestType& data) override { return sizeof(TestType); }
 };
 
 TEST(AssetTests, CanRegisterAssetType)
 {
+    TestAssetBuilder testAssetBuilder;
     asset::Registry registry({
         .contentPrefix = ".",
         .enableMultithreadedLoad = false
     });
 
-    TestAssetBuilder testAssetBuilder;
     registry.RegisterAssetType<TestHandle, TestType>({
         .identifierHash = HashString(".test_asset"),
         .initialCapacity = 16,
@@ -44,6 +46,40 @@ TEST(AssetTests, CanRegisterAssetType)
 
 namespace
 {
+    // Stands in for the file on disk changing between hot reloads
+    uint32_t g_reloadLeafValue = 1;
+
+    void SerializeTestAsset(Vector<uint8_t>& outData, uint32_t value, Span<std::string_view> references)
+    {
+        TestType data = {
+            .data = value
+        };
+
+        // Test identifiers are sanitized already, so we can hash them the same way data_build does
+        Vector<asset::schema::AssetReference> resolvedReferences;
+        for (std::string_view reference : references)
+        {
+            resolvedReferences.push_back({
+                .identifierHash = HashString(reference),
+                .extensionHash = HashString(".test_asset"),
+                .path = reference
+            });
+        }
+
+        Span<uint8_t> payload = { reinterpret_cast<uint8_t*>(&data), sizeof(data) };
+        asset::schema::Asset asset = {
+            .identifier = ".test_asset",
+            .references = resolvedReferences,
+            .contentHash = asset::HashAssetContent(".test_asset", payload, resolvedReferences),
+            .assetData = payload
+        };
+
+        uint64_t size = asset::schema::Asset::SerializedSize(asset);
+        outData.resize(size);
+
+        rn::Serialize<asset::schema::Asset>(outData, asset);
+    }
+
     class MappedTestAsset : public asset::MappedAsset
     {
     public:
@@ -51,37 +87,86 @@ namespace
         {
             if (path == "test_asset_1.test_asset")
             {
-                TestType data = {
-                    .data = 0xDEADBEEF
-                };
-                
-                asset::schema::Asset asset = {
-                    .identifier = ".test_asset",
-                    .references = {},
-                    .assetData = { reinterpret_cast<uint8_t*>(&data), sizeof(data) }
-                };
+                SerializeTestAsset(_assetData, 0xDEADBEEF, {});
+            }
 
-                uint64_t size = asset::schema::Asset::SerializedSize(asset);
-                _assetData.resize(size);
+            else if (path == "test_asset_2.test_asset")
+            {
+                SerializeTestAsset(_assetData, 0xDABABADA, {});
+            }
 
-                rn::Serialize<asset::schema::Asset>(_assetData, asset);
+            else if (path == "test_asset_3.test_asset")
+            {
+                std::string_view references[] = { "test_asset_1.test_asset" };
+                SerializeTestAsset(_assetData, 0xBEEFBEEF, references);
             }
 
-            else if (path == "test_asset_2.test_asset")
+            else if (path == "test_asset_4.test_asset")
+            {
+                std::string_view references[] = { "test_asset_1.test_asset", "test_asset_3.test_asset" };
+                SerializeTestAsset(_assetData, 0xCAFECAFE, references);
+            }
+
+            // Same content as test_asset_3 under a different identifier
+            else if (path == "test_asset_5.test_asset")
+            {
+                std::string_view references[] = { "test_asset_1.test_asset" };
+                SerializeTestAsset(_assetData, 0xBEEFBEEF, references);
+            }
+
+            else if (path == "missing_reference.test_asset")
+            {
+                std::string_view references[] = { "missing.test_asset" };
+                SerializeTestAsset(_assetData, 0xFEEDFEED, references);
+            }
+
+            // Same content, the owner fails because of its missing reference
+            else if (path == "failing_owner.test_asset" || path == "failing_sharer.test_asset")
+            {
+                std::string_view references[] = { "nested_load.test_asset", "missing.test_asset" };
+                SerializeTestAsset(_assetData, 0xF00DF00D, references);
+            }
+
+            else if (path == "nested_load.test_asset")
+            {
+                SerializeTestAsset(_assetData, 0x10AD10AD, {});
+            }
+
+            else if (path == "cycle_a.test_asset")
             {
-                TestType data = {
-                    .data = 0xDABABADA
+                std::string_view references[] = { "cycle_b.test_asset" };
+                SerializeTestAsset(_assetData, 0xA, references);
+            }
+
+            else if (path == "cycle_b.test_asset")
+            {
+                std::string_view references[] = { "cycle_a.test_asset" };
+                SerializeTestAsset(_assetData, 0xB, references);
+            }
+
+            // Written by something other than data_build
+            else if (path == "corrupt.test_asset")
+            {
+                const char text[] = "not an asset";
+                _assetData.assign(text, text + sizeof(text));
+            }
+
+            // Valid asset file, whose chunk table claims more compressed data than the payload holds
+            else if (path == "corrupt_payload.test_asset")
+            {
+                uint8_t payload[] = { 0xFF, 0xAB, 0xBA, 0xDD };
+                asset::schema::CompressedChunk chunks[] = {
+                    { .compressedSize = 64, .uncompressedSize = sizeof(TestType) }
                 };
 
                 asset::schema::Asset asset = {
                     .identifier = ".test_asset",
-                    .references = {},
-                    .assetData = { reinterpret_cast<uint8_t*>(&data), sizeof(data) }
+                    .compression = asset::schema::AssetCompression::LZ4,
+                    .chunks = chunks,
+                    .assetData = payload
                 };
 
-                uint64_t size = asset::schema::Asset::SerializedSize(asset);
-                _assetData.resize(size);
-
+                _assetData.resize(asset::schema::Asset::SerializedSize(asset));
                 rn::Serialize<asset::schema::Asset>(_assetData, asset);
             }
         }
@@ -94,22 +179,143 @@ namespace
         Vector<uint8_t> _assetData;
     };
 
-    asset::MappedAsset* MapTestAsset(MemoryScope& scope, const String& path)
+    // reload_root -> reload_mid -> reload_leaf, reload_other stands on its own
+    class MappedReloadTestAsset : public asset::MappedAsset
+    {
+    public:
+        MappedReloadTestAsset(const String& path)
+        {
+            if (path == "reload_leaf.test_asset")
+            {
+                SerializeTestAsset(_assetData, g_reloadLeafValue, {});
+            }
+
+            else if (path == "reload_mid.test_asset")
+            {
+                std::string_view references[] = { "reload_leaf.test_asset" };
+                SerializeTestAsset(_assetData, 2, references);
+            }
+
+            else if (path == "reload_root.test_asset")
+            {
+                std::string_view references[] = { "reload_mid.test_asset" };
+                SerializeTestAsset(_assetData, 3, references);
+            }
+
+            else if (path == "reload_other.test_asset")
+            {
+                SerializeTestAsset(_assetData, 4, {});
+            }
+        }
+
+        Span<const uint8_t> Ptr() const override
+        {
+            return _assetData;
+        }
+
+        Vector<uint8_t> _assetData;
+    };
+
+    TrackedUniquePtr<asset::MappedAsset> MapReloadTestAsset(const String& path)
+    {
+        return TrackedUniquePtr<asset::MappedAsset>(TrackedNew<MappedReloadTestAsset>(asset::MemoryCategory::Asset, path));
+    }
+
+    class CountingTestAssetBuilder : public TestAssetBuilder
+    {
+    public:
+
+        TestType Build(const asset::AssetBuildDesc& desc) override
+        {
+            ++buildCount;
+            return TestAssetBuilder::Build(desc);
+        }
+
+        void Destroy(TestType& data) override
+        {
+            ++destroyCount;
+        }
+
+        size_t buildCount = 0;
+        size_t destroyCount = 0;
+    };
+
+    // Every build gets a new value, destroying a value which a sharer still resolves to counts as a stale destroy
+    class SharerCheckingTestAssetBuilder : public TestAssetBuilder
+    {
+    public:
+
+        TestType Build(const asset::AssetBuildDesc& desc) override
+        {
+            return { .data = ++buildCount };
+        }
+
+        void Destroy(TestType& data) override
+        {
+            if (IsValid(sharer) && registry->Resolve<TestHandle, TestType>(sharer)->data == data.data)
+            {
+                ++staleDestroyCount;
+            }
+        }
+
+        asset::Registry* registry = nullptr;
+        TestHandle sharer = TestHandle::Invalid;
+        uint32_t buildCount = 0;
+        size_t staleDestroyCount = 0;
+    };
+
+    // Loads another asset in the middle of building one, while the asset being built or its dependent isn't resident yet
+    class NestedLoadTestAssetBuilder : public TestAssetBuilder
+    {
+    public:
+
+        TestType Build(const asset::AssetBuildDesc& desc) override
+        {
+            if (desc.identifier == buildIdentifier && loadAsBatch)
+            {
+                std::string_view identifiers[] = { nestedIdentifier };
+                nestedBatch = registry->LoadBatch(identifiers);
+                registry->WaitForBatch(nestedBatch);
+                nestedHandle = TestHandle(registry->BatchAssets(nestedBatch)[0]);
+                nestedResidentCount = registry->BankStats<TestHandle>().residentCount;
+            }
+            else if (desc.identifier == buildIdentifier)
+            {
+                nestedHandle = registry->Load<TestHandle>(nestedIdentifier);
+                nestedResidentCount = registry->BankStats<TestHandle>().residentCount;
+            }
+
+            return TestAssetBuilder::Build(desc);
+        }
+
+        asset::Registry* registry = nullptr;
+        std::string_view buildIdentifier;
+        std::string_view nestedIdentifier;
+        bool loadAsBatch = false;
+        asset::Batch nestedBatch = asset::Batch::Invalid;
+        TestHandle nestedHandle = TestHandle::Invalid;
+        size_t nestedResidentCount = 0;
+    };
+
+    TrackedUniquePtr<asset::MappedAsset> MapTestAsset(const String& path)
     {
-        return ScopedNew<MappedTestAsset>(scope, path);
+        TrackedUniquePtr<asset::MappedAsset> mapping(TrackedNew<MappedTestAsset>(asset::MemoryCategory::Asset, path));
+
+        // Anything not listed above doesn't exist
+        return mapping->Ptr().empty() ? nullptr : std::move(mapping);
     }
 }
 
 TEST(AssetTests, CanLoadAsset)
 {
     
+    TestAssetBuilder testAssetBuilder;
     asset::Registry registry({
         .contentPrefix = "",
         .enableMultithreadedLoad = true,
         .onMapAsset = MapTestAsset
     });
 
-    TestAssetBuilder testAssetBuilder;
     registry.RegisterAssetType<TestHandle, TestType>({
         .identifierHash = HashString(".test_asset"),
         .initialCapacity = 16,
@@ -127,4 +333,628 @@ TEST(AssetTests, CanLoadAsset)
 
     const TestType* data2 = registry.Resolve<TestHandle, TestType>(handle2);
     EXPECT_EQ(data2->data, 0xDABABADA);
+}
+
+TEST(AssetTests, CanLoadBatch)
+{
+    TestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = true,
+        .onMapAsset = MapTestAsset
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    std::string_view identifiers[] = {
+        "test_asset_4.test_asset",
+        "test_asset_3.test_asset",
+        "test_asset_2.test_asset"
+    };
+
+    asset::Batch batch = registry.LoadBatch(identifiers);
+    EXPECT_TRUE(IsValid(batch));
+
+    registry.WaitForBatch(batch);
+    EXPECT_TRUE(registry.IsBatchComplete(batch));
+
+    Span<const asset::Asset> assets = registry.BatchAssets(batch);
+    EXPECT_EQ(assets.size(), 3);
+
+    constexpr const uint32_t EXPECTED_VALUES[] = { 0xCAFECAFE, 0xBEEFBEEF, 0xDABABADA };
+    for (size_t i = 0; i < assets.size(); ++i)
+    {
+        TestHandle handle = TestHandle(assets[i]);
+        EXPECT_TRUE(IsValid(handle));
+        const TestType* data = registry.Resolve<TestHandle, TestType>(handle);
+        EXPECT_EQ(data->data, EXPECTED_VALUES[i]);
+    }
+
+    // Shared references are only loaded once
+    TestHandle sharedHandle = registry.Load<TestHandle>("test_asset_1.test_asset");
+    const TestType* sharedData = registry.Resolve<TestHandle, TestType>(sharedHandle);
+    EXPECT_EQ(sharedData->data, 0xDEADBEEF);
+
+    TestHandle loadedHandle = registry.Load<TestHandle>("test_asset_3.test_asset");
+    EXPECT_EQ(loadedHandle, TestHandle(assets[1]));
+
+    registry.ReleaseBatch(batch);
+}
+
+TEST(AssetTests, EvictsReleasedAssetsOverBudget)
+{
+    TestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder,
+        .memoryBudgetInBytes = sizeof(TestType)
+    });
+
+    // Referenced assets never get evicted, even when over budget
+    TestHandle handle1 = registry.Load<TestHandle>("test_asset_1.test_asset");
+    TestHandle handle2 = registry.Load<TestHandle>("test_asset_2.test_asset");
+
+    asset::AssetBankStats stats = registry.BankStats<TestHandle>();
+    EXPECT_EQ(stats.residentCount, 2);
+    EXPECT_EQ(stats.residentBytes, 2 * sizeof(TestType));
+    EXPECT_EQ(stats.evictionCount, 0);
+
+    registry.Release(handle1);
+    const TestType* data1 = registry.Resolve<TestHandle, TestType>(handle1);
+    const TestType* data2 = registry.Resolve<TestHandle, TestType>(handle2);
+    EXPECT_EQ(data1, nullptr);
+    EXPECT_EQ(data2->data, 0xDABABADA);
+
+    stats = registry.BankStats<TestHandle>();
+    EXPECT_EQ(stats.residentCount, 1);
+    EXPECT_EQ(stats.evictionCount, 1);
+    EXPECT_EQ(stats.evictedBytes, sizeof(TestType));
+
+    // Evicted assets get loaded into a new handle
+    TestHandle reloadedHandle1 = registry.Load<TestHandle>("test_asset_1.test_asset");
+    const TestType* reloadedData1 = registry.Resolve<TestHandle, TestType>(reloadedHandle1);
+    EXPECT_NE(reloadedHandle1, handle1);
+    EXPECT_EQ(reloadedData1->data, 0xDEADBEEF);
+}
+
+TEST(AssetTests, EvictingAssetReleasesDependencies)
+{
+    TestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    TestHandle handle1 = registry.Load<TestHandle>("test_asset_1.test_asset");
+    TestHandle handle4 = registry.Load<TestHandle>("test_asset_4.test_asset");
+
+    // Unbounded budget, nothing gets evicted until asked to
+    registry.Release(handle4);
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 3);
+
+    registry.EvictUnreferenced();
+    const TestType* data1 = registry.Resolve<TestHandle, TestType>(handle1);
+    const TestType* data4 = registry.Resolve<TestHandle, TestType>(handle4);
+    EXPECT_EQ(data4, nullptr);
+    EXPECT_EQ(data1->data, 0xDEADBEEF);
+
+    asset::AssetBankStats stats = registry.BankStats<TestHandle>();
+    EXPECT_EQ(stats.residentCount, 1);
+    EXPECT_EQ(stats.evictionCount, 2);
+
+    registry.Release(handle1);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 0);
+}
+
+TEST(AssetTests, RecordsLoadTelemetry)
+{
+    TestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset,
+        .enableLoadTelemetry = true
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    std::string_view identifiers[] = { "test_asset_2.test_asset" };
+    asset::Batch batch = registry.LoadBatch(identifiers);
+    registry.WaitForBatch(batch);
+    TestHandle handle = registry.Load<TestHandle>("test_asset_4.test_asset");
+
+    // Every asset is recorded once, dependencies included
+    asset::LoadTelemetry* telemetry = registry.Telemetry();
+    ASSERT_NE(telemetry, nullptr);
+
+    Vector<asset::AssetLoadRecord> records = telemetry->Records();
+    ASSERT_EQ(records.size(), 4);
+
+    size_t bytesRead = 0;
+    for (const asset::AssetLoadRecord& record : records)
+    {
+        EXPECT_EQ(record.extensionHash, HashString(".test_asset"));
+        EXPECT_GT(record.bytesRead, 0);
+        bytesRead += record.bytesRead;
+    }
+
+    Vector<asset::AssetTypeLoadStats> typeStats = telemetry->TypeStats();
+    ASSERT_EQ(typeStats.size(), 1);
+    EXPECT_EQ(typeStats[0].extension, ".test_asset");
+    EXPECT_EQ(typeStats[0].loadCount, 4);
+    EXPECT_EQ(typeStats[0].bytesRead, bytesRead);
+
+    String csv = telemetry->ExportCSV();
+    EXPECT_EQ(std::count(csv.begin(), csv.end(), '\n'), 5);
+    EXPECT_NE(telemetry->ExportJSON().find("\"extension\": \".test_asset\""), String::npos);
+
+    telemetry->Reset();
+    EXPECT_TRUE(telemetry->Records().empty());
+    EXPECT_TRUE(telemetry->TypeStats().empty());
+
+    registry.Release(handle);
+    registry.ReleaseBatch(batch);
+}
+
+TEST(AssetTests, LoadTelemetryKeepsRecentRecords)
+{
+    asset::LoadTelemetry telemetry;
+
+    constexpr size_t OVERWRITTEN_COUNT = 10;
+    constexpr size_t RECORD_COUNT = asset::LoadTelemetry::MAX_RECORD_COUNT + OVERWRITTEN_COUNT;
+    for (size_t i = 0; i < RECORD_COUNT; ++i)
+    {
+        telemetry.Record({
+            .identifier = "test_asset.test_asset",
+            .extensionHash = HashString(".test_asset"),
+            .bytesRead = i
+        });
+    }
+
+    // The oldest records get dropped, totals still count them
+    Vector<asset::AssetLoadRecord> records = telemetry.Records();
+    ASSERT_EQ(records.size(), asset::LoadTelemetry::MAX_RECORD_COUNT);
+    EXPECT_EQ(records.front().bytesRead, OVERWRITTEN_COUNT);
+    EXPECT_EQ(records.back().bytesRead, RECORD_COUNT - 1);
+
+    Vector<asset::AssetTypeLoadStats> typeStats = telemetry.TypeStats();
+    ASSERT_EQ(typeStats.size(), 1);
+    EXPECT_EQ(typeStats[0].loadCount, RECORD_COUNT);
+    EXPECT_EQ(typeStats[0].bytesRead, RECORD_COUNT * (RECORD_COUNT - 1) / 2);
+}
+
+TEST(AssetTests, SharesIdenticalContent)
+{
+    TestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    TestHandle handle3 = registry.Load<TestHandle>("test_asset_3.test_asset");
+    TestHandle handle5 = registry.Load<TestHandle>("test_asset_5.test_asset");
+    EXPECT_NE(handle3, handle5);
+
+    const TestType* data3 = registry.Resolve<TestHandle, TestType>(handle3);
+    const TestType* data5 = registry.Resolve<TestHandle, TestType>(handle5);
+    EXPECT_EQ(data5->data, data3->data);
+
+    // The shared copy doesn't load test_asset_1 again, nor count against the budget
+    asset::AssetBankStats stats = registry.BankStats<TestHandle>();
+    EXPECT_EQ(stats.residentCount, 3);
+    EXPECT_EQ(stats.sharedCount, 1);
+    EXPECT_EQ(stats.residentBytes, 2 * sizeof(TestType));
+
+    // The owner stays resident as long as anything shares its data
+    registry.Release(handle3);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 3);
+
+    registry.Release(handle5);
+    registry.EvictUnreferenced();
+    stats = registry.BankStats<TestHandle>();
+    EXPECT_EQ(stats.residentCount, 0);
+    EXPECT_EQ(stats.sharedCount, 0);
+}
+
+TEST(AssetTests, RebuildingOwnersUpdatesSharersFirst)
+{
+    SharerCheckingTestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset
+    });
+
+    testAssetBuilder.registry = &registry;
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    TestHandle handle3 = registry.Load<TestHandle>("test_asset_3.test_asset");
+    TestHandle handle5 = registry.Load<TestHandle>("test_asset_5.test_asset");
+    testAssetBuilder.sharer = handle5;
+
+    // The sharer never resolves to the owner's previous data once it's destroyed
+    TestHandle reloaded = registry.Load<TestHandle>("test_asset_3.test_asset", asset::LoadFlags::ReloadShallow);
+    EXPECT_EQ(reloaded, handle3);
+    EXPECT_EQ(testAssetBuilder.staleDestroyCount, 0);
+
+    const TestType* data3 = registry.Resolve<TestHandle, TestType>(handle3);
+    const TestType* data5 = registry.Resolve<TestHandle, TestType>(handle5);
+    EXPECT_EQ(data3->data, testAssetBuilder.buildCount);
+    EXPECT_EQ(data5->data, data3->data);
+
+    testAssetBuilder.sharer = TestHandle::Invalid;
+    registry.Release(reloaded);
+    registry.Release(handle3);
+    registry.Release(handle5);
+}
+
+TEST(AssetTests, DestroysResidentAssetsWithTheRegistry)
+{
+    CountingTestAssetBuilder testAssetBuilder;
+    size_t loadDestroyCount = 0;
+    {
+        asset::Registry registry({
+            .contentPrefix = "",
+            .enableMultithreadedLoad = false,
+            .onMapAsset = MapTestAsset
+        });
+
+        registry.RegisterAssetType<TestHandle, TestType>({
+            .identifierHash = HashString(".test_asset"),
+            .initialCapacity = 16,
+            .builder = &testAssetBuilder
+        });
+
+        // Leaves an unreferenced asset waiting for eviction next to referenced ones and a sharer
+        TestHandle handle3 = registry.Load<TestHandle>("test_asset_3.test_asset");
+        registry.Load<TestHandle>("test_asset_5.test_asset");
+        registry.Release(handle3);
+        EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 3);
+        loadDestroyCount = testAssetBuilder.destroyCount;
+    }
+
+    // Sharers don't own the data they copied
+    EXPECT_EQ(testAssetBuilder.buildCount, 2);
+    EXPECT_EQ(testAssetBuilder.destroyCount - loadDestroyCount, 2);
+}
+
+TEST(AssetTests, SharesIdenticalContentWithinBatch)
+{
+    TestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = true,
+        .onMapAsset = MapTestAsset
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    std::string_view identifiers[] = { "test_asset_3.test_asset", "test_asset_5.test_asset" };
+    asset::Batch batch = registry.LoadBatch(identifiers);
+    registry.WaitForBatch(batch);
+
+    Span<const asset::Asset> assets = registry.BatchAssets(batch);
+    ASSERT_EQ(assets.size(), 2);
+    const TestType* data3 = registry.Resolve<TestHandle, TestType>(TestHandle(assets[0]));
+    const TestType* data5 = registry.Resolve<TestHandle, TestType>(TestHandle(assets[1]));
+    EXPECT_EQ(data3->data, 0xBEEFBEEF);
+    EXPECT_EQ(data5->data, 0xBEEFBEEF);
+
+    asset::AssetBankStats stats = registry.BankStats<TestHandle>();
+    EXPECT_EQ(stats.residentCount, 3);
+    EXPECT_EQ(stats.sharedCount, 1);
+
+    registry.Release(assets[0]);
+    registry.Release(assets[1]);
+    registry.ReleaseBatch(batch);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 0);
+}
+
+TEST(AssetTests, ReloadsChangedAssetsAndDependents)
+{
+    CountingTestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapReloadTestAsset,
+        .enableHotReload = true
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    g_reloadLeafValue = 1;
+    TestHandle rootHandle = registry.Load<TestHandle>("reload_root.test_asset");
+    TestHandle otherHandle = registry.Load<TestHandle>("reload_other.test_asset");
+    TestHandle leafHandle = registry.Load<TestHandle>("reload_leaf.test_asset");
+    EXPECT_EQ(testAssetBuilder.buildCount, 4);
+
+    // Touched, but unchanged
+    std::string_view unchanged[] = { "reload_leaf.test_asset", "reload_other.test_asset", "never_loaded.test_asset" };
+    EXPECT_EQ(registry.ReloadChanged(unchanged), 0);
+    EXPECT_EQ(testAssetBuilder.buildCount, 4);
+
+    // The leaf and everything referencing it get rebuilt in place, the unrelated asset doesn't
+    g_reloadLeafValue = 5;
+    std::string_view changed[] = { "Reload_Leaf.test_asset", "reload_other.test_asset" };
+    EXPECT_EQ(registry.ReloadChanged(changed), 3);
+    EXPECT_EQ(testAssetBuilder.buildCount, 7);
+
+    const TestType* leafData = registry.Resolve<TestHandle, TestType>(leafHandle);
+    EXPECT_EQ(leafData->data, 5);
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 4);
+
+    // Rebuilding keeps reference counts intact
+    registry.Release(rootHandle);
+    registry.Release(otherHandle);
+    registry.Release(leafHandle);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 0);
+}
+
+
+TEST(AssetTests, FailsLoadsOfMissingAndInvalidAssets)
+{
+    TestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    // Failed loads still hand out a reference to the handle, which stays NotResident
+    TestHandle missing = registry.Load<TestHandle>("missing.test_asset");
+    TestHandle corrupt = registry.Load<TestHandle>("corrupt.test_asset");
+    TestHandle corruptPayload = registry.Load<TestHandle>("corrupt_payload.test_asset");
+    EXPECT_TRUE(IsValid(missing));
+    EXPECT_TRUE(IsValid(corrupt));
+    EXPECT_TRUE(IsValid(corruptPayload));
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 0);
+
+    // Assets referencing a failed load fail along with it
+    TestHandle dependent = registry.Load<TestHandle>("missing_reference.test_asset");
+    EXPECT_TRUE(IsValid(dependent));
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 0);
+
+    registry.Release(missing);
+    registry.Release(corrupt);
+    registry.Release(corruptPayload);
+    registry.Release(dependent);
+
+    // Released failed loads are forgotten, so loading them again tries again
+    TestHandle reloaded = registry.Load<TestHandle>("missing.test_asset");
+    EXPECT_NE(reloaded, missing);
+    registry.Release(reloaded);
+
+    TestHandle handle2 = registry.Load<TestHandle>("test_asset_2.test_asset");
+    const TestType* data2 = registry.Resolve<TestHandle, TestType>(handle2);
+    EXPECT_EQ(data2->data, 0xDABABADA);
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 1);
+    registry.Release(handle2);
+}
+
+TEST(AssetTests, FailsBatchLoadsOfMissingAndInvalidAssets)
+{
+    TestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = true,
+        .onMapAsset = MapTestAsset
+    });
+
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    std::string_view identifiers[] = {
+        "missing_reference.test_asset",
+        "corrupt.test_asset",
+        "corrupt_payload.test_asset",
+        "test_asset_2.test_asset"
+    };
+
+    asset::Batch batch = registry.LoadBatch(identifiers);
+    registry.WaitForBatch(batch);
+    EXPECT_TRUE(registry.IsBatchComplete(batch));
+
+    // Failures don't affect unrelated assets in the same batch
+    Span<const asset::Asset> assets = registry.BatchAssets(batch);
+    ASSERT_EQ(assets.size(), 4);
+    const TestType* data2 = registry.Resolve<TestHandle, TestType>(TestHandle(assets[3]));
+    EXPECT_EQ(data2->data, 0xDABABADA);
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 1);
+
+    for (asset::Asset asset : assets)
+    {
+        registry.Release(asset);
+    }
+    registry.ReleaseBatch(batch);
+
+    // Dependencies which failed to load outside of the batch fail their dependents right away
+    TestHandle missing = registry.Load<TestHandle>("missing.test_asset");
+    std::string_view dependents[] = { "missing_reference.test_asset" };
+    batch = registry.LoadBatch(dependents);
+    registry.WaitForBatch(batch);
+    EXPECT_TRUE(registry.IsBatchComplete(batch));
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 1);
+
+    registry.Release(registry.BatchAssets(batch)[0]);
+    registry.ReleaseBatch(batch);
+    registry.Release(missing);
+}
+
+TEST(AssetTests, SharersWaitForTheirOwnerToBeBuilt)
+{
+    NestedLoadTestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset
+    });
+
+    testAssetBuilder.registry = &registry;
+    testAssetBuilder.buildIdentifier = "test_asset_3.test_asset";
+    testAssetBuilder.nestedIdentifier = "test_asset_5.test_asset";
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    // test_asset_5 finds test_asset_3 owning its content while it's still being built
+    TestHandle handle3 = registry.Load<TestHandle>("test_asset_3.test_asset");
+    TestHandle handle5 = testAssetBuilder.nestedHandle;
+    EXPECT_TRUE(IsValid(handle5));
+    EXPECT_EQ(testAssetBuilder.nestedResidentCount, 1);
+
+    // Building the owner completes the sharer's load
+    const TestType* data5 = registry.Resolve<TestHandle, TestType>(handle5);
+    EXPECT_EQ(data5->data, 0xBEEFBEEF);
+
+    asset::AssetBankStats stats = registry.BankStats<TestHandle>();
+    EXPECT_EQ(stats.residentCount, 3);
+    EXPECT_EQ(stats.sharedCount, 1);
+
+    registry.Release(handle3);
+    registry.Release(handle5);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 0);
+}
+
+TEST(AssetTests, SharersFailAlongWithTheirOwner)
+{
+    NestedLoadTestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset
+    });
+
+    testAssetBuilder.registry = &registry;
+    testAssetBuilder.buildIdentifier = "nested_load.test_asset";
+    testAssetBuilder.nestedIdentifier = "failing_sharer.test_asset";
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    // failing_sharer gets loaded while failing_owner is loading its references, one of which doesn't exist
+    TestHandle owner = registry.Load<TestHandle>("failing_owner.test_asset");
+    TestHandle sharer = testAssetBuilder.nestedHandle;
+    EXPECT_TRUE(IsValid(sharer));
+
+    asset::AssetBankStats stats = registry.BankStats<TestHandle>();
+    EXPECT_EQ(stats.residentCount, 1);
+    EXPECT_EQ(stats.sharedCount, 0);
+
+    // The sharer let go of its owner when it failed, so releasing both removes them
+    registry.Release(owner);
+    registry.Release(sharer);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 0);
+
+    testAssetBuilder.buildIdentifier = {};
+    TestHandle reloadedSharer = registry.Load<TestHandle>("failing_sharer.test_asset");
+    EXPECT_NE(reloadedSharer, sharer);
+    registry.Release(reloadedSharer);
+}
+
+TEST(AssetTests, BatchesFailReferencesTheyCantWaitFor)
+{
+    NestedLoadTestAssetBuilder testAssetBuilder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapTestAsset
+    });
+
+    testAssetBuilder.registry = &registry;
+    testAssetBuilder.buildIdentifier = "test_asset_1.test_asset";
+    testAssetBuilder.nestedIdentifier = "test_asset_3.test_asset";
+    testAssetBuilder.loadAsBatch = true;
+    registry.RegisterAssetType<TestHandle, TestType>({
+        .identifierHash = HashString(".test_asset"),
+        .initialCapacity = 16,
+        .builder = &testAssetBuilder
+    });
+
+    // The batch runs while test_asset_1 is being built further up the call stack, so it can't wait for it
+    TestHandle handle1 = registry.Load<TestHandle>("test_asset_1.test_asset");
+    EXPECT_TRUE(registry.IsBatchComplete(testAssetBuilder.nestedBatch));
+    EXPECT_EQ(testAssetBuilder.nestedResidentCount, 0);
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 1);
+
+    registry.Release(testAssetBuilder.nestedHandle);
+    registry.ReleaseBatch(testAssetBuilder.nestedBatch);
+
+    // Circular references fail instead of never becoming ready
+    std::string_view identifiers[] = { "cycle_a.test_asset", "test_asset_3.test_asset" };
+    asset::Batch batch = registry.LoadBatch(identifiers);
+    registry.WaitForBatch(batch);
+    EXPECT_TRUE(registry.IsBatchComplete(batch));
+
+    Span<const asset::Asset> assets = registry.BatchAssets(batch);
+    ASSERT_EQ(assets.size(), 2);
+    const TestType* data3 = registry.Resolve<TestHandle, TestType>(TestHandle(assets[1]));
+    EXPECT_EQ(data3->data, 0xBEEFBEEF);
+    EXPECT_EQ(registry.BankStats<TestHandle>().residentCount, 2);
+
+    for (asset::Asset asset : assets)
+    {
+        registry.Release(asset);
+    }
+    registry.ReleaseBatch(batch);
+    registry.Release(handle1);
 }
\ No newline at end of file
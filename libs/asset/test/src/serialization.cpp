@@ -1,17 +1,19 @@
 #include <gtest/gtest.h>
 
 #include "common/memory/memory.hpp"
+#include "common/memory/vector.hpp"
 #include "asset_gen.hpp"
 #include "reference_gen.hpp"
+#include "serialization_test_gen.hpp"
 #include "luagen/schema.hpp"
 
 TEST(SerializationTests, SerializeAndDeserializeAsset)
 {
     using namespace rn::asset;
 
-    std::string_view references[] = {
-        "reference_one.texture",
-        "reference_two.texture"
+    schema::AssetReference references[] = {
+        { .identifierHash = 0x1234, .extensionHash = 0xABCD, .path = "reference_one.texture" },
+        { .identifierHash = 0x5678, .extensionHash = 0xABCD, .path = "reference_two.texture" }
     };
 
     uint8_t data[] = { 0xFF, 0xAB, 0xBA, 0xDD };
@@ -35,7 +37,9 @@ TEST(SerializationTests, SerializeAndDeserializeAsset)
 
     for (int i = 0; i < preSerialization.references.size(); ++i)
     {
-        EXPECT_EQ(preSerialization.references[i], postSerializaiton.references[i]);
+        EXPECT_EQ(preSerialization.references[i].identifierHash, postSerializaiton.references[i].identifierHash);
+        EXPECT_EQ(preSerialization.references[i].extensionHash, postSerializaiton.references[i].extensionHash);
+        EXPECT_EQ(preSerialization.references[i].path, postSerializaiton.references[i].path);
     }
 
     EXPECT_TRUE(std::memcmp(preSerialization.assetData.data(), postSerializaiton.assetData.data(), preSerialization.assetData.size()) == 0);
@@ -59,4 +63,427 @@ TEST(SerializationTests, SerializeAndDeserializeReference)
     offset = 0;
     schema::Reference postSerializaiton = schema::Reference::Deserialize(destSpan, offset, [](size_t size) { return rn::ScopedAlloc(size, 64); });
     EXPECT_EQ(preSerialization.identifier, postSerializaiton.identifier);
-}
\ No newline at end of file
+}
+
+TEST(SerializationTests, BulkSerializesFixedLayoutSpans)
+{
+    using namespace rn::asset;
+
+    static_assert(rn::internal::IsBulkSerializableV<schema::CompressedChunk>);
+    static_assert(rn::internal::IsBulkSerializableV<schema::AssetCompression>);
+    static_assert(!rn::internal::IsBulkSerializableV<schema::AssetReference>);
+
+    schema::CompressedChunk chunks[] = {
+        { .compressedSize = 12, .uncompressedSize = 64 },
+        { .compressedSize = 20, .uncompressedSize = 48 },
+        { .compressedSize = 7, .uncompressedSize = 7 }
+    };
+
+    uint8_t data[1024];
+    for (int i = 0; i < std::size(data); ++i)
+    {
+        data[i] = uint8_t(i * 31);
+    }
+
+    schema::Asset preSerialization = {
+        .identifier = "bulk",
+        .compression = schema::AssetCompression::LZ4,
+        .contentHash = { .lower = 0x1234, .upper = 0x5678 },
+        .chunks = chunks,
+        .assetData = data
+    };
+
+    uint64_t destSize = schema::Asset::SerializedSize(preSerialization);
+    EXPECT_EQ(schema::CompressedChunk::FixedSerializedSize, sizeof(schema::CompressedChunk));
+
+    rn::Span<uint8_t> destSpan = { static_cast<uint8_t*>(rn::ScopedAlloc(destSize, 64)), destSize };
+    EXPECT_EQ(destSize, rn::Serialize<schema::Asset>(destSpan, preSerialization));
+
+    schema::Asset postSerialization = rn::Deserialize<schema::Asset>(destSpan, [](size_t size) { return rn::ScopedAlloc(size, 64); });
+    EXPECT_EQ(preSerialization.compression, postSerialization.compression);
+    EXPECT_EQ(preSerialization.contentHash.upper, postSerialization.contentHash.upper);
+    ASSERT_EQ(std::size(chunks), postSerialization.chunks.size());
+    for (int i = 0; i < std::size(chunks); ++i)
+    {
+        EXPECT_EQ(chunks[i].compressedSize, postSerialization.chunks[i].compressedSize);
+        EXPECT_EQ(chunks[i].uncompressedSize, postSerialization.chunks[i].uncompressedSize);
+    }
+
+    ASSERT_EQ(std::size(data), postSerialization.assetData.size());
+    EXPECT_TRUE(std::memcmp(data, postSerialization.assetData.data(), std::size(data)) == 0);
+}
+
+TEST(SerializationTests, DeserializeViewPointsIntoSource)
+{
+    using namespace rn::asset;
+
+    schema::AssetReference references[] = {
+        { .identifierHash = 0x1234, .extensionHash = 0xABCD, .path = "reference_one.texture" },
+        { .identifierHash = 0x5678, .extensionHash = 0xABCD, .path = "reference_two.texture" }
+    };
+
+    uint8_t data[] = { 0xFF, 0xAB, 0xBA, 0xDD };
+
+    schema::Asset preSerialization = {
+        .identifier = "view",
+        .references = references,
+        .assetData = data
+    };
+
+    uint64_t destSize = schema::Asset::SerializedSize(preSerialization);
+    rn::Span<uint8_t> destSpan = { static_cast<uint8_t*>(rn::ScopedAlloc(destSize, 64)), destSize };
+    rn::Serialize<schema::Asset>(destSpan, preSerialization);
+
+    static size_t allocationCount = 0;
+    auto fnAlloc = [](size_t size)
+    {
+        allocationCount++;
+        return rn::ScopedAlloc(size, 64);
+    };
+
+    schema::Asset view = rn::DeserializeView<schema::Asset>(destSpan, fnAlloc);
+
+    // Only the array of variable sized references needs an allocation, chunks are empty
+    EXPECT_EQ(allocationCount, 1);
+
+    auto fnIsInSource = [&destSpan](const void* ptr)
+    {
+        return ptr >= destSpan.data() && ptr < destSpan.data() + destSpan.size();
+    };
+
+    EXPECT_EQ(view.identifier, preSerialization.identifier);
+    EXPECT_TRUE(fnIsInSource(view.identifier.data()));
+    ASSERT_EQ(view.references.size(), std::size(references));
+    EXPECT_FALSE(fnIsInSource(view.references.data()));
+
+    for (int i = 0; i < std::size(references); ++i)
+    {
+        EXPECT_EQ(view.references[i].identifierHash, references[i].identifierHash);
+        EXPECT_EQ(view.references[i].path, references[i].path);
+        EXPECT_TRUE(fnIsInSource(view.references[i].path.data()));
+    }
+
+    ASSERT_EQ(view.assetData.size(), sizeof(data));
+    EXPECT_TRUE(fnIsInSource(view.assetData.data()));
+    EXPECT_TRUE(std::memcmp(view.assetData.data(), data, sizeof(data)) == 0);
+}
+
+TEST(SerializationTests, AlignsSpanElements)
+{
+    using namespace rn::asset;
+
+    schema::CompressedChunk chunks[] = {
+        { .compressedSize = 3, .uncompressedSize = 5 }
+    };
+
+    uint8_t data[] = { 0x01, 0x02, 0x03 };
+
+    // An identifier of odd length leaves every following field misaligned, unless padded
+    schema::Asset preSerialization = {
+        .identifier = "odd",
+        .chunks = chunks,
+        .assetData = data
+    };
+
+    uint64_t destSize = schema::Asset::SerializedSize(preSerialization);
+    auto fnSerialize = [&](uint8_t fill)
+    {
+        rn::Span<uint8_t> destSpan = { static_cast<uint8_t*>(rn::ScopedAlloc(destSize, rn::SERIALIZED_MAX_ALIGNMENT)), destSize };
+        std::memset(destSpan.data(), fill, destSize);
+        EXPECT_EQ(destSize, rn::Serialize<schema::Asset>(destSpan, preSerialization));
+        return destSpan;
+    };
+
+    rn::Span<uint8_t> destSpan = fnSerialize(0xCD);
+
+    // Padding doesn't leak whatever was in the buffer before
+    EXPECT_TRUE(std::memcmp(destSpan.data(), fnSerialize(0xAB).data(), destSize) == 0);
+
+    schema::Asset view = rn::DeserializeView<schema::Asset>(destSpan, [](size_t size) { return rn::ScopedAlloc(size, 64); });
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(view.chunks.data()) % alignof(schema::CompressedChunk), 0);
+    EXPECT_EQ((view.assetData.data() - destSpan.data()) % 512, 0);
+    EXPECT_EQ(view.chunks[0].uncompressedSize, 5);
+    EXPECT_TRUE(std::memcmp(view.assetData.data(), data, sizeof(data)) == 0);
+
+    // Copies read the padded layout back just the same
+    schema::Asset copied = rn::Deserialize<schema::Asset>(destSpan, [](size_t size) { return rn::ScopedAlloc(size, 64); });
+    EXPECT_EQ(copied.identifier, "odd");
+    EXPECT_EQ(copied.chunks[0].compressedSize, 3);
+    ASSERT_EQ(copied.assetData.size(), sizeof(data));
+    EXPECT_TRUE(std::memcmp(copied.assetData.data(), data, sizeof(data)) == 0);
+}
+
+TEST(SerializationTests, AccessorReadsSingleFields)
+{
+    using namespace rn::asset;
+
+    schema::AssetReference references[] = {
+        { .identifierHash = 0x1234, .extensionHash = 0xABCD, .path = "reference_one.texture" }
+    };
+
+    uint8_t data[] = { 0xFF, 0xAB, 0xBA, 0xDD };
+
+    schema::Asset preSerialization = {
+        .identifier = "accessor",
+        .references = references,
+        .compression = schema::AssetCompression::Zstd,
+        .contentHash = { .lower = 0xAAAA, .upper = 0xBBBB },
+        .assetData = data
+    };
+
+    uint64_t destSize = schema::Asset::SerializedSize(preSerialization);
+    rn::Span<uint8_t> destSpan = { static_cast<uint8_t*>(rn::ScopedAlloc(destSize, rn::SERIALIZED_MAX_ALIGNMENT)), destSize };
+    rn::Serialize<schema::Asset>(destSpan, preSerialization);
+
+    // Fields are read in any order, without going through the ones before them
+    schema::Asset::Accessor accessor(destSpan);
+    EXPECT_EQ(accessor.contentHash().upper, 0xBBBB);
+    EXPECT_EQ(accessor.compression(), schema::AssetCompression::Zstd);
+    EXPECT_EQ(accessor.identifier(), "accessor");
+
+    rn::Span<uint8_t> assetData = accessor.assetData();
+    ASSERT_EQ(assetData.size(), sizeof(data));
+    EXPECT_TRUE(std::memcmp(assetData.data(), data, sizeof(data)) == 0);
+
+    // Spans of variable sized types need somewhere to put their elements
+    rn::Span<schema::AssetReference> accessedReferences = accessor.references([](size_t size) { return rn::ScopedAlloc(size, 64); });
+    ASSERT_EQ(accessedReferences.size(), 1);
+    EXPECT_EQ(accessedReferences[0].path, references[0].path);
+}
+
+TEST(SerializationTests, DeserializesWithSingleAllocation)
+{
+    using namespace rn::asset;
+
+    schema::AssetReference references[] = {
+        { .identifierHash = 0x1234, .extensionHash = 0xABCD, .path = "reference_one.texture" },
+        { .identifierHash = 0x5678, .extensionHash = 0xABCD, .path = "reference_two.material" },
+        { .identifierHash = 0x9ABC, .extensionHash = 0xABCD, .path = "three" }
+    };
+
+    schema::CompressedChunk chunks[] = {
+        { .compressedSize = 3, .uncompressedSize = 5 }
+    };
+
+    uint8_t data[] = { 0xFF, 0xAB, 0xBA };
+
+    schema::Asset preSerialization = {
+        .identifier = "single",
+        .references = references,
+        .chunks = chunks,
+        .assetData = data
+    };
+
+    uint64_t destSize = schema::Asset::SerializedSize(preSerialization);
+    rn::Span<uint8_t> destSpan = { static_cast<uint8_t*>(rn::ScopedAlloc(destSize, rn::SERIALIZED_MAX_ALIGNMENT)), destSize };
+    rn::Serialize<schema::Asset>(destSpan, preSerialization);
+
+    static size_t allocationCount = 0;
+    static size_t allocationSize = 0;
+    auto fnAlloc = [](size_t size)
+    {
+        allocationCount++;
+        allocationSize += size;
+        return rn::ScopedAlloc(size, 64);
+    };
+
+    void* allocation = nullptr;
+    schema::Asset copied = rn::DeserializeSingleAllocation<schema::Asset>(destSpan, fnAlloc, &allocation);
+    EXPECT_EQ(allocationCount, 1);
+
+    auto fnIsInAllocation = [&allocation](const void* ptr)
+    {
+        return ptr >= allocation && ptr < static_cast<uint8_t*>(allocation) + allocationSize;
+    };
+
+    EXPECT_EQ(copied.identifier, preSerialization.identifier);
+    EXPECT_TRUE(fnIsInAllocation(copied.identifier.data()));
+    ASSERT_EQ(copied.references.size(), std::size(references));
+    for (int i = 0; i < std::size(references); ++i)
+    {
+        EXPECT_EQ(copied.references[i].path, references[i].path);
+        EXPECT_TRUE(fnIsInAllocation(copied.references[i].path.data()));
+    }
+
+    EXPECT_EQ(copied.chunks[0].uncompressedSize, 5);
+    EXPECT_TRUE(fnIsInAllocation(copied.assetData.data()));
+    EXPECT_TRUE(std::memcmp(copied.assetData.data(), data, sizeof(data)) == 0);
+
+    // Views only allocate the reference array
+    allocationCount = 0;
+    allocationSize = 0;
+    schema::Asset view = rn::DeserializeViewSingleAllocation<schema::Asset>(destSpan, fnAlloc, &allocation);
+    EXPECT_EQ(allocationCount, 1);
+    EXPECT_EQ(allocationSize, rn::AlignSize(sizeof(references), rn::DESERIALIZED_ALLOCATION_ALIGNMENT));
+    EXPECT_TRUE(fnIsInAllocation(view.references.data()));
+    EXPECT_EQ(view.references[2].path, "three");
+}
+
+TEST(SerializationTests, SizesFixedLayoutTypesUpFront)
+{
+    using namespace rn::asset;
+
+    static_assert(schema::ContentHash::FixedSerializedSize == 2 * sizeof(uint64_t));
+    static_assert(schema::Reference::FixedSerializedSize == sizeof(uint32_t));
+
+    schema::CompressedChunk chunks[64] = {};
+    schema::Asset asset = {
+        .identifier = "fixed",
+        .chunks = chunks
+    };
+
+    // Only the chunk count is needed to size the chunks
+    EXPECT_EQ(rn::SerializedSize(asset.chunks, 0), rn::SERIALIZED_SPAN_SIZE + std::size(chunks) * schema::CompressedChunk::FixedSerializedSize);
+    EXPECT_EQ(rn::SerializedSize(asset.contentHash), schema::ContentHash::FixedSerializedSize);
+
+    uint64_t destSize = schema::Asset::SerializedSize(asset);
+    rn::Span<uint8_t> destSpan = { static_cast<uint8_t*>(rn::ScopedAlloc(destSize, rn::SERIALIZED_MAX_ALIGNMENT)), destSize };
+    EXPECT_EQ(rn::Serialize<schema::Asset>(destSpan, asset), destSize);
+}
+
+TEST(SerializationTests, StreamsToFile)
+{
+    using namespace rn::asset;
+
+    schema::AssetReference references[] = {
+        { .identifierHash = 0x1234, .extensionHash = 0xABCD, .path = "reference_one.texture" }
+    };
+
+    // Larger than the writer's buffer, so it bypasses it
+    uint8_t data[4 * rn::KILO];
+    for (int i = 0; i < std::size(data); ++i)
+    {
+        data[i] = uint8_t(i * 7);
+    }
+
+    schema::Asset asset = {
+        .identifier = "streamed",
+        .references = references,
+        .contentHash = { .lower = 0x1111, .upper = 0x2222 },
+        .assetData = data
+    };
+
+    uint64_t destSize = schema::Asset::SerializedSize(asset);
+    rn::Span<uint8_t> destSpan = { static_cast<uint8_t*>(rn::ScopedAlloc(destSize, rn::SERIALIZED_MAX_ALIGNMENT)), destSize };
+    rn::Serialize<schema::Asset>(destSpan, asset);
+
+    FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+
+    uint8_t buffer[rn::SERIALIZED_MAX_ALIGNMENT];
+    {
+        rn::SerializationWriter writer(file, buffer);
+        EXPECT_EQ(rn::Serialize<schema::Asset>(writer, asset), destSize);
+        EXPECT_TRUE(writer.Flush());
+        EXPECT_EQ(writer.BytesWritten(), destSize);
+    }
+
+    // Streams produce the exact same bytes as serializing into memory
+    rn::Vector<uint8_t> streamed(destSize + 1);
+    std::rewind(file);
+    EXPECT_EQ(std::fread(streamed.data(), 1, streamed.size(), file), destSize);
+    std::fclose(file);
+
+    EXPECT_TRUE(std::memcmp(streamed.data(), destSpan.data(), destSize) == 0);
+}
+
+TEST(SerializationTests, HashesAndComparesContent)
+{
+    using namespace rn::asset;
+
+    schema::AssetReference references[] = {
+        { .identifierHash = 0x1234, .extensionHash = 0xABCD, .path = "reference_one.texture" },
+        { .identifierHash = 0x5678, .extensionHash = 0xABCD, .path = "reference_two.texture" }
+    };
+
+    schema::AssetReference copiedReferences[] = {
+        { .identifierHash = 0x1234, .extensionHash = 0xABCD, .path = "reference_one.texture" },
+        { .identifierHash = 0x5678, .extensionHash = 0xABCD, .path = "reference_two.texture" }
+    };
+
+    uint8_t data[] = { 0xFF, 0xAB, 0xBA, 0xDD };
+    uint8_t copiedData[] = { 0xFF, 0xAB, 0xBA, 0xDD };
+
+    schema::Asset asset = {
+        .identifier = "test",
+        .references = references,
+        .assetData = data
+    };
+
+    // Same content in different memory
+    schema::Asset copy = {
+        .identifier = "test",
+        .references = copiedReferences,
+        .assetData = copiedData
+    };
+
+    EXPECT_TRUE(asset == copy);
+    EXPECT_EQ(rn::Hash(asset), rn::Hash(copy));
+
+    copiedReferences[1].path = "reference_three.texture";
+    EXPECT_FALSE(asset == copy);
+    EXPECT_NE(rn::Hash(asset), rn::Hash(copy));
+
+    copiedReferences[1].path = references[1].path;
+    copiedData[3] = 0x00;
+    EXPECT_FALSE(asset == copy);
+    EXPECT_NE(rn::Hash(asset), rn::Hash(copy));
+
+    // Moving data between neighbouring fields changes the hash
+    schema::AssetReference left = { .identifierHash = 1, .extensionHash = 2, .path = "ab" };
+    schema::AssetReference right = { .identifierHash = 1, .extensionHash = 2, .path = "a" };
+    EXPECT_NE(rn::Hash(left), rn::Hash(right));
+    EXPECT_NE(rn::Hash(left, rn::Hash(right)), rn::Hash(right, rn::Hash(left)));
+}
+
+TEST(SerializationTests, StoresStructureOfArrays)
+{
+    using namespace rn::asset::test;
+
+    float radii[] = { 1.0f, 2.5f, 4.0f };
+    uint32_t colors[] = { 0xFF0000FF, 0x00FF00FF, 0x0000FFFF };
+    uint16_t flags[] = { 1, 2, 3 };
+
+    schema::Scene preSerialization = {
+        .name = "soa",
+        .lights = { .radius = radii, .color = colors, .flags = flags },
+        .shadowedLights = { .radius = { radii, 1 }, .color = { colors, 1 }, .flags = { flags, 1 } }
+    };
+
+    uint64_t destSize = schema::Scene::SerializedSize(preSerialization);
+    rn::Span<uint8_t> destSpan = { static_cast<uint8_t*>(rn::ScopedAlloc(destSize, rn::SERIALIZED_MAX_ALIGNMENT)), destSize };
+    EXPECT_EQ(rn::Serialize<schema::Scene>(destSpan, preSerialization), destSize);
+
+    // The element count is stored once, followed by each member's array
+    uint64_t offset = rn::SERIALIZED_SPAN_SIZE + preSerialization.name.size();
+    EXPECT_EQ(rn::DeserializeDirect<uint64_t>(destSpan, offset), 3);
+    EXPECT_EQ(std::memcmp(destSpan.data() + rn::AlignSize(offset, alignof(float)), radii, sizeof(radii)), 0);
+
+    auto fnAlloc = [](size_t size) { return rn::ScopedAlloc(size, 64); };
+    schema::Scene view = rn::DeserializeView<schema::Scene>(destSpan, fnAlloc);
+    ASSERT_EQ(view.lights.size(), 3);
+    EXPECT_EQ(view.lights.flags[2], 3);
+
+    // Every member array points into the source, aligned for its own type or the field's alignment
+    auto fnSourceOffset = [&destSpan](const void* ptr)
+    {
+        return uint64_t(static_cast<const uint8_t*>(ptr) - destSpan.data());
+    };
+
+    EXPECT_LT(fnSourceOffset(view.lights.radius.data()), destSize);
+    EXPECT_EQ(fnSourceOffset(view.lights.color.data()) % alignof(uint32_t), 0);
+    EXPECT_EQ(fnSourceOffset(view.lights.flags.data()) % alignof(uint16_t), 0);
+    EXPECT_EQ(fnSourceOffset(view.shadowedLights.radius.data()) % 32, 0);
+    EXPECT_EQ(fnSourceOffset(view.shadowedLights.color.data()) % 32, 0);
+    EXPECT_EQ(fnSourceOffset(view.shadowedLights.flags.data()) % 32, 0);
+
+    schema::Light light = view.lights[1];
+    EXPECT_EQ(light.radius, 2.5f);
+    EXPECT_EQ(light.color, 0x00FF00FF);
+    EXPECT_EQ(light.flags, 2);
+
+    schema::Scene copied = rn::DeserializeSingleAllocation<schema::Scene>(destSpan, fnAlloc);
+    EXPECT_TRUE(copied == preSerialization);
+    EXPECT_EQ(rn::Hash(copied), rn::Hash(preSerialization));
+    EXPECT_NE(copied.lights.radius.data(), view.lights.radius.data());
+}
@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "asset/streaming.hpp"
+
+#include "asset_gen.hpp"
+#include "luagen/schema.hpp"
+
+using namespace rn;
+
+RN_DEFINE_HANDLE(StreamedHandle, 0x91);
+struct StreamedType
+{
+    uint32_t data;
+};
+
+namespace
+{
+    class StreamedAssetBuilder : public asset::Builder<StreamedHandle, StreamedType>
+    {
+    public:
+
+        StreamedType Build(const asset::AssetBuildDesc& desc) override
+        {
+            RN_ASSERT(desc.data.size() == sizeof(StreamedType));
+            return *reinterpret_cast<const StreamedType*>(desc.data.data());
+        }
+
+        void Destroy(StreamedType& data) override {}
+        void Finalize() override {}
+        size_t MemoryFootprint(const StreamedType& data) override { return sizeof(StreamedType); }
+    };
+
+    class MappedStreamedAsset : public asset::MappedAsset
+    {
+    public:
+        MappedStreamedAsset(const String& path)
+        {
+            StreamedType data = {
+                .data = uint32_t(path.size())
+            };
+
+            asset::schema::Asset asset = {
+                .identifier = ".streamed",
+                .assetData = { reinterpret_cast<uint8_t*>(&data), sizeof(data) }
+            };
+
+            _assetData.resize(asset::schema::Asset::SerializedSize(asset));
+            rn::Serialize<asset::schema::Asset>(_assetData, asset);
+        }
+
+        Span<const uint8_t> Ptr() const override
+        {
+            return _assetData;
+        }
+
+        Vector<uint8_t> _assetData;
+    };
+
+    TrackedUniquePtr<asset::MappedAsset> MapStreamedAsset(const String& path)
+    {
+        return TrackedUniquePtr<asset::MappedAsset>(TrackedNew<MappedStreamedAsset>(asset::MemoryCategory::Asset, path));
+    }
+}
+
+TEST(StreamingTests, StartsRequestsInPriorityOrder)
+{
+    StreamedAssetBuilder builder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapStreamedAsset
+    });
+
+    registry.RegisterAssetType<StreamedHandle, StreamedType>({
+        .identifierHash = HashString(".streamed"),
+        .initialCapacity = 16,
+        .builder = &builder
+    });
+
+    asset::StreamingQueue queue(&registry, {
+        .maxInFlightRequests = 1
+    });
+
+    asset::StreamRequest prefetch = queue.Request("prefetch.streamed", asset::StreamPriority::Prefetch);
+    asset::StreamRequest far = queue.Request("far.streamed", asset::StreamPriority::Normal, 100.0f);
+    asset::StreamRequest near = queue.Request("near.streamed", asset::StreamPriority::Normal, 1.0f);
+    asset::StreamRequest critical = queue.Request("critical.streamed", asset::StreamPriority::Critical);
+
+    queue.Update();
+    EXPECT_EQ(queue.Status(critical), asset::StreamStatus::InFlight);
+    EXPECT_EQ(queue.PendingCount(), 3);
+
+    // Moving closer to the far asset makes it more urgent than the near one
+    queue.Reprioritize(far, asset::StreamPriority::Normal, 0.5f);
+
+    queue.Update();
+    EXPECT_EQ(queue.Status(critical), asset::StreamStatus::Complete);
+    EXPECT_EQ(queue.Status(far), asset::StreamStatus::InFlight);
+    EXPECT_EQ(queue.Status(near), asset::StreamStatus::Pending);
+
+    // Releasing a pending request cancels it
+    queue.Release(prefetch);
+    EXPECT_EQ(queue.PendingCount(), 1);
+
+    queue.Update();
+    queue.Update();
+    EXPECT_EQ(queue.Status(near), asset::StreamStatus::Complete);
+    EXPECT_EQ(queue.PendingCount(), 0);
+    EXPECT_EQ(queue.InFlightCount(), 0);
+
+    const StreamedType* data = registry.Resolve<StreamedHandle, StreamedType>(StreamedHandle(queue.Result(near)));
+    EXPECT_EQ(data->data, uint32_t(std::string_view("near.streamed").size()));
+
+    EXPECT_EQ(queue.LatencyStats(asset::StreamPriority::Normal).sampleCount, 2);
+    EXPECT_EQ(queue.LatencyStats(asset::StreamPriority::Critical).sampleCount, 1);
+    EXPECT_EQ(queue.LatencyStats(asset::StreamPriority::Prefetch).sampleCount, 0);
+
+    queue.Release(critical);
+    queue.Release(far);
+    queue.Release(near);
+}
+
+TEST(StreamingTests, CoalescesRepeatedRequests)
+{
+    StreamedAssetBuilder builder;
+    asset::Registry registry({
+        .contentPrefix = "",
+        .enableMultithreadedLoad = false,
+        .onMapAsset = MapStreamedAsset
+    });
+
+    registry.RegisterAssetType<StreamedHandle, StreamedType>({
+        .identifierHash = HashString(".streamed"),
+        .initialCapacity = 16,
+        .builder = &builder
+    });
+
+    asset::StreamingQueue queue(&registry, {});
+
+    asset::StreamRequest first = queue.Request("coalesced.streamed", asset::StreamPriority::Prefetch);
+    asset::StreamRequest second = queue.Request("Coalesced.streamed", asset::StreamPriority::Critical);
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(queue.PendingCount(), 1);
+
+    queue.Update();
+    queue.Update();
+    EXPECT_EQ(queue.Status(first), asset::StreamStatus::Complete);
+    EXPECT_EQ(queue.LatencyStats(asset::StreamPriority::Critical).sampleCount, 1);
+
+    // The asset stays referenced until the last coalesced request is released
+    queue.Release(first);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<StreamedHandle>().residentCount, 1);
+
+    queue.Release(second);
+    registry.EvictUnreferenced();
+    EXPECT_EQ(registry.BankStats<StreamedHandle>().residentCount, 0);
+}
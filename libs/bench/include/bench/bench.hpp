@@ -0,0 +1,104 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "common/memory/span.hpp"
+
+#include <charconv>
+#include <cstdio>
+#include <string_view>
+#include <system_error>
+
+namespace rn::bench
+{
+    struct OptionDesc
+    {
+        std::string_view option;
+        std::string_view parameter;
+        std::string_view description;
+    };
+
+    struct Option
+    {
+        std::string_view option;
+        std::string_view parameter;
+
+        // Set when the parameter is an unsigned integer
+        bool isNumber = false;
+        size_t value = 0;
+    };
+
+    inline bool ParseUint(std::string_view str, size_t& outValue)
+    {
+        auto [ptr, err] = std::from_chars(str.data(), str.data() + str.size(), outValue);
+        return err == std::errc() && ptr == str.data() + str.size();
+    }
+
+    inline void PrintUsage(std::string_view benchName, Span<const OptionDesc> options)
+    {
+        std::printf("Usage: %.*s [OPTION]...\n", int(benchName.size()), benchName.data());
+        for (const OptionDesc& option : options)
+        {
+            char optionText[64];
+            std::snprintf(optionText, sizeof(optionText), "%.*s %.*s",
+                int(option.option.size()), option.option.data(),
+                int(option.parameter.size()), option.parameter.data());
+
+            std::printf("%-19s%.*s\n", optionText, int(option.description.size()), option.description.data());
+        }
+    }
+
+    // Every option takes a parameter. fnParseOption returns false for options it doesn't accept.
+    template <typename FnParseOption>
+    bool ParseOptions(int argc, char* argv[], FnParseOption&& fnParseOption)
+    {
+        for (int argIdx = 1; argIdx < argc; ++argIdx)
+        {
+            std::string_view arg = argv[argIdx];
+            if (arg == "-h")
+            {
+                return false;
+            }
+
+            if (argIdx + 1 >= argc)
+            {
+                std::fprintf(stderr, "ERROR: Missing parameter for option %s\n", argv[argIdx]);
+                return false;
+            }
+
+            Option option = {
+                .option = arg,
+                .parameter = argv[++argIdx]
+            };
+            option.isNumber = ParseUint(option.parameter, option.value);
+
+            if (!fnParseOption(option))
+            {
+                std::fprintf(stderr, "ERROR: Invalid option %s %s\n", argv[argIdx - 1], argv[argIdx]);
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Noise in the low half of every byte, so compression has some work to do without being pointless
+    class NoiseGenerator
+    {
+    public:
+
+        void Fill(Span<uint8_t> bytes)
+        {
+            for (uint8_t& byte : bytes)
+            {
+                _state ^= _state << 13;
+                _state ^= _state >> 7;
+                _state ^= _state << 17;
+                byte = uint8_t(_state & 0x0F);
+            }
+        }
+
+    private:
+
+        uint64_t _state = 0x9E3779B97F4A7C15;
+    };
+}
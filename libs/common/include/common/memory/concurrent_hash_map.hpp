@@ -0,0 +1,240 @@
+#pragma once
+
+#include "common/common.hpp"
+#include "common/memory/memory.hpp"
+#include "common/memory/vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <mutex>
+#include <shared_mutex>
+#include <type_traits>
+
+namespace rn
+{
+    // Open addressing map from non-zero 64-bit hashes to 64-bit handles, built for read-mostly concurrent access.
+    // Lookups are lock-free. Keys are inserted and values swapped with CAS, writers only ever wait on a resize.
+    // Keys are never removed, exchanging a value for ValueType::Invalid is the equivalent of erasing it.
+    template <typename ValueType>
+    class ConcurrentHashMap
+    {
+        static_assert(sizeof(ValueType) == sizeof(uint64_t));
+
+    public:
+
+        ConcurrentHashMap(MemoryCategoryID cat, size_t initialCapacity)
+            : _cat(cat)
+        {
+            _table.store(AllocateTable(std::max<size_t>(std::bit_ceil(initialCapacity * 2), MIN_CAPACITY)), std::memory_order_relaxed);
+        }
+
+        ~ConcurrentHashMap()
+        {
+            FreeTable(_table.load(std::memory_order_relaxed));
+            for (Table* table : _retiredTables)
+            {
+                FreeTable(table);
+            }
+        }
+
+        ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+        ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+        ValueType Find(uint64_t key) const
+        {
+            RN_ASSERT(key != EMPTY_KEY);
+
+            const Table* table = _table.load(std::memory_order_acquire);
+            const Slot* slot = FindSlot(table, key);
+
+            return slot ? ValueType(slot->value.load(std::memory_order_acquire)) : ValueType::Invalid;
+        }
+
+        // Replaces the key's value with desired if it currently holds expected, inserting the key if needed.
+        // On failure, expected receives the current value.
+        bool CompareExchange(uint64_t key, ValueType& expected, ValueType desired)
+        {
+            RN_ASSERT(key != EMPTY_KEY);
+
+            bool exchanged = false;
+            bool needsResize = false;
+            Table* table = nullptr;
+            {
+                std::shared_lock lock(_resizeMutex);
+                table = _table.load(std::memory_order_acquire);
+
+                std::pair<Slot*, bool> slot = FindOrInsertSlot(table, key);
+                if (slot.second)
+                {
+                    // Keep the load factor at or below 50%
+                    size_t count = _count.fetch_add(1, std::memory_order_relaxed) + 1;
+                    needsResize = count * 2 > table->capacity;
+                }
+
+                uint64_t expectedValue = uint64_t(expected);
+                exchanged = slot.first->value.compare_exchange_strong(expectedValue, uint64_t(desired), std::memory_order_acq_rel);
+                expected = ValueType(expectedValue);
+            }
+
+            if (needsResize)
+            {
+                Grow(table);
+            }
+
+            return exchanged;
+        }
+
+        // Visits every key holding a valid value. Doesn't synchronize with writers, meant for when they're done.
+        template <typename Fn>
+        void ForEach(Fn&& fn) const
+        {
+            const Table* table = _table.load(std::memory_order_acquire);
+            for (size_t idx = 0; idx < table->capacity; ++idx)
+            {
+                const Slot& slot = table->slots[idx];
+                uint64_t key = slot.key.load(std::memory_order_acquire);
+                ValueType value = ValueType(slot.value.load(std::memory_order_acquire));
+                if (key != EMPTY_KEY && value != ValueType::Invalid)
+                {
+                    fn(key, value);
+                }
+            }
+        }
+
+    private:
+
+        static constexpr uint64_t EMPTY_KEY = 0;
+        static constexpr size_t MIN_CAPACITY = 64;
+
+        struct alignas(16) Slot
+        {
+            std::atomic<uint64_t> key;
+            std::atomic<uint64_t> value;
+        };
+
+        struct Table
+        {
+            size_t capacity;
+            uint32_t shift;
+            Slot* slots;
+        };
+
+        static size_t StartIndex(const Table* table, uint64_t key)
+        {
+            // Fibonacci hashing spreads keys which only differ in their low bits
+            return size_t((key * 0x9E3779B97F4A7C15ull) >> table->shift);
+        }
+
+        static const Slot* FindSlot(const Table* table, uint64_t key)
+        {
+            size_t mask = table->capacity - 1;
+            size_t idx = StartIndex(table, key);
+            for (size_t probe = 0; probe < table->capacity; ++probe)
+            {
+                const Slot& slot = table->slots[idx];
+                uint64_t slotKey = slot.key.load(std::memory_order_acquire);
+                if (slotKey == key)
+                {
+                    return &slot;
+                }
+
+                if (slotKey == EMPTY_KEY)
+                {
+                    return nullptr;
+                }
+
+                idx = (idx + 1) & mask;
+            }
+
+            return nullptr;
+        }
+
+        static std::pair<Slot*, bool> FindOrInsertSlot(Table* table, uint64_t key)
+        {
+            size_t mask = table->capacity - 1;
+            size_t idx = StartIndex(table, key);
+            for (size_t probe = 0; probe < table->capacity; ++probe)
+            {
+                Slot& slot = table->slots[idx];
+                uint64_t slotKey = slot.key.load(std::memory_order_acquire);
+                if (slotKey == EMPTY_KEY && slot.key.compare_exchange_strong(slotKey, key, std::memory_order_acq_rel))
+                {
+                    return std::make_pair(&slot, true);
+                }
+
+                // Either the slot was taken already, or another thread claimed it first
+                if (slotKey == key)
+                {
+                    return std::make_pair(&slot, false);
+                }
+
+                idx = (idx + 1) & mask;
+            }
+
+            // Resizing keeps the table at most half full
+            RN_ASSERT(false);
+            return std::make_pair(nullptr, false);
+        }
+
+        Table* AllocateTable(size_t capacity)
+        {
+            Table* table = TrackedNew<Table>(_cat);
+            table->capacity = capacity;
+            table->shift = uint32_t(64 - std::countr_zero(capacity));
+            table->slots = static_cast<Slot*>(TrackedAlloc(_cat, sizeof(Slot) * capacity, alignof(Slot)));
+
+            for (size_t i = 0; i < capacity; ++i)
+            {
+                new (&table->slots[i]) Slot();
+                table->slots[i].key.store(EMPTY_KEY, std::memory_order_relaxed);
+                table->slots[i].value.store(uint64_t(ValueType::Invalid), std::memory_order_relaxed);
+            }
+
+            return table;
+        }
+
+        void FreeTable(Table* table)
+        {
+            TrackedFree(table->slots);
+            TrackedDelete(table);
+        }
+
+        void Grow(Table* observedTable)
+        {
+            std::unique_lock lock(_resizeMutex);
+
+            // Someone else got here first
+            Table* oldTable = _table.load(std::memory_order_relaxed);
+            if (oldTable != observedTable)
+            {
+                return;
+            }
+
+            Table* newTable = AllocateTable(oldTable->capacity * 2);
+            for (size_t i = 0; i < oldTable->capacity; ++i)
+            {
+                const Slot& slot = oldTable->slots[i];
+                uint64_t key = slot.key.load(std::memory_order_relaxed);
+                if (key != EMPTY_KEY)
+                {
+                    Slot* newSlot = FindOrInsertSlot(newTable, key).first;
+                    newSlot->value.store(slot.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                }
+            }
+
+            _table.store(newTable, std::memory_order_release);
+
+            // Lock-free readers may still be probing the old table
+            _retiredTables.push_back(oldTable);
+        }
+
+        MemoryCategoryID _cat;
+
+        std::atomic<Table*> _table = nullptr;
+        std::atomic<size_t> _count = 0;
+
+        std::shared_mutex _resizeMutex;
+        Vector<Table*> _retiredTables = MakeVector<Table*>(_cat);
+    };
+}
@@ -226,6 +226,34 @@ namespace rn
             return &_coldStorage[index];
         }
 
+        // Runs fn on the cold data while holding the pool's shared lock, so it can't be removed or moved by a resize in
+        // the meantime. Returns false for stale handles, fn's result otherwise.
+        template <typename Fn, typename C = ColdType>
+        requires (!std::is_void_v<C>) 
+        bool VisitColdMutable(HandleType handle, Fn&& fn) const
+        {
+            if (!IsValid(handle))
+            {
+                return false;
+            }
+
+            uint64_t index = IndexFromHandle(handle);
+
+            std::shared_lock lock(_mutex);
+            if (index >= _capacity)
+            {
+                return false;
+            }
+
+            uint8_t generation = _generationList[index];
+            if (generation != GenerationFromHandle(handle))
+            {
+                return false;
+            }
+
+            return fn(_coldStorage[index]);
+        }
+
         template <typename C = ColdType>
         requires (!std::is_void_v<C>) 
         const C* GetColdPtr(HandleType handle) const
@@ -126,6 +126,11 @@ namespace rn
         }
 
         uintptr_t uBasePtr = uintptr_t(malloc(actualSize));
+        if (uBasePtr == 0)
+        {
+            return nullptr;
+        }
+
         uintptr_t uDataPtr = AlignSize(uBasePtr + sizeof(AllocationTrackingBlock), alignment);
         uintptr_t uTrackingPtr = uDataPtr - sizeof(AllocationTrackingBlock); 
 
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include "common/handle.hpp"
+#include "common/memory/memory.hpp"
+#include "common/memory/concurrent_hash_map.hpp"
+
+#include <thread>
+
+using namespace rn;
+
+RN_MEMORY_CATEGORY(Test)
+RN_DEFINE_HANDLE(MappedHandle, 0x34)
+
+TEST(ConcurrentHashMapTests, CanInsertAndFind)
+{
+    ConcurrentHashMap<MappedHandle> map(::MemoryCategory::Test, 16);
+    EXPECT_EQ(map.Find(42), MappedHandle::Invalid);
+
+    MappedHandle expected = MappedHandle::Invalid;
+    EXPECT_TRUE(map.CompareExchange(42, expected, MappedHandle(1)));
+    EXPECT_EQ(map.Find(42), MappedHandle(1));
+
+    // Exchanging from a stale value fails and reports the current one
+    expected = MappedHandle::Invalid;
+    EXPECT_FALSE(map.CompareExchange(42, expected, MappedHandle(2)));
+    EXPECT_EQ(expected, MappedHandle(1));
+
+    // Resetting a key to Invalid is the equivalent of erasing it
+    EXPECT_TRUE(map.CompareExchange(42, expected, MappedHandle::Invalid));
+    EXPECT_EQ(map.Find(42), MappedHandle::Invalid);
+}
+
+TEST(ConcurrentHashMapTests, VisitsValidEntries)
+{
+    ConcurrentHashMap<MappedHandle> map(::MemoryCategory::Test, 1);
+
+    constexpr uint64_t KEY_COUNT = 100;
+    for (uint64_t key = 1; key <= KEY_COUNT; ++key)
+    {
+        MappedHandle expected = MappedHandle::Invalid;
+        EXPECT_TRUE(map.CompareExchange(key, expected, MappedHandle(key)));
+    }
+
+    // Erased keys are skipped
+    MappedHandle expected = MappedHandle(1);
+    EXPECT_TRUE(map.CompareExchange(1, expected, MappedHandle::Invalid));
+
+    uint64_t visitCount = 0;
+    map.ForEach([&visitCount](uint64_t key, MappedHandle value)
+    {
+        EXPECT_EQ(value, MappedHandle(key));
+        EXPECT_NE(key, 1);
+        ++visitCount;
+    });
+
+    EXPECT_EQ(visitCount, KEY_COUNT - 1);
+}
+
+TEST(ConcurrentHashMapTests, KeepsEntriesWhenGrowing)
+{
+    ConcurrentHashMap<MappedHandle> map(::MemoryCategory::Test, 1);
+
+    constexpr uint64_t KEY_COUNT = 10000;
+    for (uint64_t key = 1; key <= KEY_COUNT; ++key)
+    {
+        MappedHandle expected = MappedHandle::Invalid;
+        EXPECT_TRUE(map.CompareExchange(key, expected, MappedHandle(key)));
+    }
+
+    for (uint64_t key = 1; key <= KEY_COUNT; ++key)
+    {
+        EXPECT_EQ(map.Find(key), MappedHandle(key));
+    }
+}
+
+TEST(ConcurrentHashMapTests, OnlyOneInsertWinsPerKey)
+{
+    ConcurrentHashMap<MappedHandle> map(::MemoryCategory::Test, 1);
+
+    constexpr uint64_t THREAD_COUNT = 4;
+    constexpr uint64_t KEY_COUNT = 4096;
+
+    std::atomic<uint64_t> winCount = 0;
+    std::thread threads[THREAD_COUNT];
+    for (uint64_t t = 0; t < THREAD_COUNT; ++t)
+    {
+        threads[t] = std::thread([&map, &winCount, t]()
+        {
+            for (uint64_t key = 1; key <= KEY_COUNT; ++key)
+            {
+                MappedHandle expected = MappedHandle::Invalid;
+                if (map.CompareExchange(key, expected, MappedHandle(t + 1)))
+                {
+                    winCount.fetch_add(1);
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(winCount.load(), KEY_COUNT);
+    for (uint64_t key = 1; key <= KEY_COUNT; ++key)
+    {
+        EXPECT_NE(map.Find(key), MappedHandle::Invalid);
+    }
+}
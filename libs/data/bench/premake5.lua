@@ -0,0 +1,26 @@
+project "luagen_bench"
+
+    kind "ConsoleApp"
+    language "C++"
+    cppdialect "C++20"
+    flags { "FatalWarnings", "MultiProcessorCompile" }
+
+    -- The generated schema code is built in directly, the rest of rnData and its RHI dependencies aren't needed
+    files {
+        "src/**.hpp",
+        "src/**.cpp",
+        PROJECT_ROOT .. "/build/codegen/rnData/**.cpp",
+    }
+
+    includedirs(RN_COMMON_INCLUDES)
+    includedirs(RN_ASSET_INCLUDES)
+    includedirs(RN_DATA_INCLUDES)
+    includedirs { "../../bench/include" }
+
+    libdirs {
+        "%{wks.location}/%{cfg.buildcfg}"
+    }
+
+    targetdir "%{wks.location}/%{cfg.buildcfg}/"
+
+    links { "rnCommon", "rnAsset", "lz4", "zstd" }
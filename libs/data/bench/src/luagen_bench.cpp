@@ -0,0 +1,537 @@
+#include "common/common.hpp"
+#include "common/memory/memory.hpp"
+#include "common/memory/string.hpp"
+#include "common/memory/vector.hpp"
+
+#include "asset_gen.hpp"
+#include "geometry_gen.hpp"
+#include "material_shader_gen.hpp"
+#include "texture_gen.hpp"
+#include "luagen/schema.hpp"
+#include "bench/bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+
+using namespace rn;
+using namespace std::literals;
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchOptions
+    {
+        uint32_t iterations = 15;
+        std::string_view jsonPath = "luagen_bench.json";
+    };
+
+    // Instances are scaled up from roughly the size of a small asset of their type
+    constexpr const uint32_t BENCH_SCALES[] = { 1, 16, 256 };
+
+    // Small instances are called repeatedly per sample, so the clock's resolution doesn't dominate their timings
+    constexpr const uint64_t MIN_SAMPLE_BYTES = 16 * MEGA;
+
+    constexpr const size_t DESERIALIZE_SCRATCH_SIZE = 512 * MEGA;
+
+    // Owns everything the spans and strings of a synthetic instance point to
+    class InstanceStorage
+    {
+    public:
+
+        InstanceStorage() = default;
+        InstanceStorage(const InstanceStorage&) = delete;
+        InstanceStorage& operator=(const InstanceStorage&) = delete;
+
+        ~InstanceStorage()
+        {
+            for (void* ptr : _allocations)
+            {
+                TrackedFree(ptr);
+            }
+        }
+
+        template <typename T>
+        Span<T> Allocate(size_t count)
+        {
+            T* ptr = static_cast<T*>(TrackedAlloc(MemoryCategory::Default, std::max<size_t>(sizeof(T) * count, 1), alignof(T)));
+            std::uninitialized_value_construct_n(ptr, count);
+            _allocations.push_back(ptr);
+            return { ptr, count };
+        }
+
+        Span<uint8_t> AllocateNoise(size_t size)
+        {
+            Span<uint8_t> bytes = Allocate<uint8_t>(size);
+            _noise.Fill(bytes);
+            return bytes;
+        }
+
+        std::string_view Format(const char* format, ...)
+        {
+            char buffer[256];
+
+            va_list args;
+            va_start(args, format);
+            int length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+            va_end(args);
+
+            Span<char> str = Allocate<char>(size_t(length));
+            std::memcpy(str.data(), buffer, str.size());
+            return { str.data(), str.size() };
+        }
+
+    private:
+
+        Vector<void*> _allocations = MakeVector<void*>(MemoryCategory::Default);
+        bench::NoiseGenerator _noise;
+    };
+
+    asset::schema::Asset MakeAsset(InstanceStorage& storage, uint32_t scale)
+    {
+        Span<asset::schema::AssetReference> references = storage.Allocate<asset::schema::AssetReference>(4 * scale);
+        for (uint32_t idx = 0; idx < references.size(); ++idx)
+        {
+            std::string_view path = storage.Format("content/bench/texture_%u.texture", idx);
+            references[idx] = {
+                .identifierHash = HashString(path.data(), path.size()),
+                .extensionHash = HashString(".texture"),
+                .path = path
+            };
+        }
+
+        Span<uint8_t> assetData = storage.AllocateNoise(scale * 16 * KILO);
+        Span<asset::schema::CompressedChunk> chunks = storage.Allocate<asset::schema::CompressedChunk>(scale);
+        for (asset::schema::CompressedChunk& chunk : chunks)
+        {
+            chunk = {
+                .compressedSize = uint32_t(assetData.size() / chunks.size()),
+                .uncompressedSize = uint32_t(assetData.size() / chunks.size())
+            };
+        }
+
+        return {
+            .identifier = ".geometry",
+            .references = references,
+            .compression = asset::schema::AssetCompression::None,
+            .contentHash = { .lower = 0x0123456789ABCDEF, .upper = 0xFEDCBA9876543210 },
+            .chunks = chunks,
+            .assetData = assetData
+        };
+    }
+
+    data::schema::Geometry MakeGeometry(InstanceStorage& storage, uint32_t scale)
+    {
+        constexpr const uint32_t MESHLETS_PER_PART = 32;
+
+        Span<data::schema::GeometryPart> parts = storage.Allocate<data::schema::GeometryPart>(4 * scale);
+        for (uint32_t partIdx = 0; partIdx < parts.size(); ++partIdx)
+        {
+            data::schema::MeshletSoA meshlets = {
+                .vertexOffset = storage.Allocate<uint32_t>(MESHLETS_PER_PART),
+                .triangleOffset = storage.Allocate<uint32_t>(MESHLETS_PER_PART),
+                .vertexCount = storage.Allocate<uint32_t>(MESHLETS_PER_PART),
+                .triangleCount = storage.Allocate<uint32_t>(MESHLETS_PER_PART)
+            };
+
+            for (uint32_t meshletIdx = 0; meshletIdx < MESHLETS_PER_PART; ++meshletIdx)
+            {
+                meshlets.vertexOffset[meshletIdx] = meshletIdx * 64;
+                meshlets.triangleOffset[meshletIdx] = meshletIdx * 124 * 3;
+                meshlets.vertexCount[meshletIdx] = 64;
+                meshlets.triangleCount[meshletIdx] = 124;
+            }
+
+            parts[partIdx] = {
+                .materialIdx = partIdx % 4,
+                .baseVertex = partIdx * MESHLETS_PER_PART * 64,
+                .indices = { .offsetInBytes = partIdx * 4 * KILO, .sizeInBytes = 4 * KILO },
+                .indexFormat = rhi::IndexFormat(0),
+                .meshlets = meshlets,
+                .meshletVertices = { .offsetInBytes = partIdx * 8 * KILO, .sizeInBytes = 8 * KILO },
+                .meshletIndices = { .offsetInBytes = partIdx * 12 * KILO, .sizeInBytes = 12 * KILO }
+            };
+        }
+
+        Span<data::schema::VertexStream> vertexStreams = storage.Allocate<data::schema::VertexStream>(3);
+        vertexStreams[0] = { .type = data::schema::VertexStreamType::Normal, .componentCount = 3, .stride = 12 };
+        vertexStreams[1] = { .type = data::schema::VertexStreamType::Tangent, .componentCount = 4, .stride = 16 };
+        vertexStreams[2] = { .type = data::schema::VertexStreamType::UV, .componentCount = 2, .stride = 8 };
+
+        return {
+            .aabb = { .min = { -1.0f, -1.0f, -1.0f }, .max = { 1.0f, 1.0f, 1.0f } },
+            .parts = parts,
+            .positions = { .type = data::schema::VertexStreamType::Position, .componentCount = 3, .stride = 12 },
+            .vertexStreams = vertexStreams,
+            .data = storage.AllocateNoise(scale * 64 * KILO)
+        };
+    }
+
+    data::schema::Texture MakeTexture(InstanceStorage& storage, uint32_t scale)
+    {
+        return {
+            .dataFormat = data::schema::TextureDataFormat::Basis,
+            .usage = data::schema::TextureUsage::Diffuse,
+            .data = storage.AllocateNoise(scale * 64 * KILO)
+        };
+    }
+
+    data::schema::Bytecode MakeBytecode(InstanceStorage& storage, size_t size)
+    {
+        return {
+            .d3d12 = storage.AllocateNoise(size),
+            .vulkan = storage.AllocateNoise(size)
+        };
+    }
+
+    template <typename T>
+    Span<T> MakeVector4(InstanceStorage& storage, T value)
+    {
+        Span<T> values = storage.Allocate<T>(4);
+        std::fill(values.begin(), values.end(), value);
+        return values;
+    }
+
+    // Lots of small spans and strings, unlike the other schemas which are dominated by a single payload
+    data::schema::MaterialShader MakeMaterialShader(InstanceStorage& storage, uint32_t scale)
+    {
+        Span<data::schema::VertexRasterPass> vertexRasterPasses = storage.Allocate<data::schema::VertexRasterPass>(2);
+        for (uint32_t passIdx = 0; passIdx < vertexRasterPasses.size(); ++passIdx)
+        {
+            vertexRasterPasses[passIdx] = {
+                .renderPass = data::MaterialRenderPass(passIdx),
+                .vertexShader = MakeBytecode(storage, scale * KILO),
+                .pixelShader = MakeBytecode(storage, scale * KILO)
+            };
+        }
+
+        Span<data::schema::MeshRasterPass> meshRasterPasses = storage.Allocate<data::schema::MeshRasterPass>(1);
+        meshRasterPasses[0] = {
+            .renderPass = data::MaterialRenderPass(0),
+            .meshShader = MakeBytecode(storage, scale * KILO),
+            .ampShader = MakeBytecode(storage, scale * KILO),
+            .pixelShader = MakeBytecode(storage, scale * KILO)
+        };
+
+        Span<data::schema::RayTracingPass> rayTracingPasses = storage.Allocate<data::schema::RayTracingPass>(scale);
+        for (uint32_t passIdx = 0; passIdx < rayTracingPasses.size(); ++passIdx)
+        {
+            rayTracingPasses[passIdx] = {
+                .renderPass = data::MaterialRenderPass(0),
+                .hitGroupName = storage.Format("HitGroup_%u", passIdx),
+                .closestHitExport = storage.Format("ClosestHit_%u", passIdx),
+                .anyHitExport = storage.Format("AnyHit_%u", passIdx)
+            };
+        }
+
+        Span<data::schema::ParameterGroup> parameterGroups = storage.Allocate<data::schema::ParameterGroup>(scale);
+        for (uint32_t groupIdx = 0; groupIdx < parameterGroups.size(); ++groupIdx)
+        {
+            uint32_t offsetInBuffer = 0;
+
+            Span<data::schema::TextureParameter> textureParameters = storage.Allocate<data::schema::TextureParameter>(4);
+            for (uint32_t paramIdx = 0; paramIdx < textureParameters.size(); ++paramIdx)
+            {
+                textureParameters[paramIdx] = {
+                    .name = storage.Format("texture_%u_%u", groupIdx, paramIdx),
+                    .offsetInBuffer = offsetInBuffer,
+                    .type = data::TextureType(0),
+                    .defaultValue = { .identifier = paramIdx }
+                };
+                offsetInBuffer += 4;
+            }
+
+            Span<data::schema::FloatVecParameter> floatVecParameters = storage.Allocate<data::schema::FloatVecParameter>(4);
+            for (uint32_t paramIdx = 0; paramIdx < floatVecParameters.size(); ++paramIdx)
+            {
+                floatVecParameters[paramIdx] = {
+                    .name = storage.Format("float_%u_%u", groupIdx, paramIdx),
+                    .offsetInBuffer = offsetInBuffer,
+                    .dimension = 4,
+                    .defaultValue = MakeVector4(storage, 0.5f),
+                    .minValue = MakeVector4(storage, 0.0f),
+                    .maxValue = MakeVector4(storage, 1.0f)
+                };
+                offsetInBuffer += 16;
+            }
+
+            Span<data::schema::UintVecParameter> uintVecParameters = storage.Allocate<data::schema::UintVecParameter>(2);
+            for (uint32_t paramIdx = 0; paramIdx < uintVecParameters.size(); ++paramIdx)
+            {
+                uintVecParameters[paramIdx] = {
+                    .name = storage.Format("uint_%u_%u", groupIdx, paramIdx),
+                    .offsetInBuffer = offsetInBuffer,
+                    .dimension = 4,
+                    .defaultValue = MakeVector4(storage, 1u),
+                    .minValue = MakeVector4(storage, 0u),
+                    .maxValue = MakeVector4(storage, 16u)
+                };
+                offsetInBuffer += 16;
+            }
+
+            Span<data::schema::IntVecParameter> intVecParameters = storage.Allocate<data::schema::IntVecParameter>(2);
+            for (uint32_t paramIdx = 0; paramIdx < intVecParameters.size(); ++paramIdx)
+            {
+                intVecParameters[paramIdx] = {
+                    .name = storage.Format("int_%u_%u", groupIdx, paramIdx),
+                    .offsetInBuffer = offsetInBuffer,
+                    .dimension = 4,
+                    .defaultValue = MakeVector4(storage, 0),
+                    .minValue = MakeVector4(storage, -16),
+                    .maxValue = MakeVector4(storage, 16)
+                };
+                offsetInBuffer += 16;
+            }
+
+            parameterGroups[groupIdx] = {
+                .name = storage.Format("group_%u", groupIdx),
+                .textureParameters = textureParameters,
+                .floatVecParameters = floatVecParameters,
+                .uintVecParameters = uintVecParameters,
+                .intVecParameters = intVecParameters
+            };
+        }
+
+        return {
+            .vertexRasterPasses = vertexRasterPasses,
+            .meshRasterPasses = meshRasterPasses,
+            .rayTracingPasses = rayTracingPasses,
+            .parameterGroups = parameterGroups,
+            .uniformDataSize = 256,
+            .rayTracingLibrary = MakeBytecode(storage, scale * 4 * KILO)
+        };
+    }
+
+    struct BenchResult
+    {
+        const char* schema;
+        uint32_t scale;
+        const char* operation;
+        uint64_t serializedBytes;
+        double medianNs;
+        double gbPerSecond;
+        double allocationsPerCall;
+        double allocatedBytesPerCall;
+    };
+
+    // Counts the allocations deserialization asks for, served from the thread's scoped allocator
+    uint64_t g_allocationCount = 0;
+    uint64_t g_allocatedBytes = 0;
+
+    void* CountedAlloc(size_t size)
+    {
+        g_allocationCount++;
+        g_allocatedBytes += size;
+        return ScopedAlloc(size, 16);
+    }
+
+    // Keeps the results of calls without side effects from being optimized out
+    volatile uint64_t g_sink = 0;
+    uint8_t g_resultSink[256];
+
+    double Median(Vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        return values[values.size() / 2];
+    }
+
+    template <typename FnCall>
+    BenchResult Measure(const char* schema, uint32_t scale, const char* operation, uint64_t serializedBytes, const BenchOptions& options, FnCall&& fnCall)
+    {
+        uint64_t callsPerSample = std::max<uint64_t>(1, MIN_SAMPLE_BYTES / serializedBytes);
+
+        // Warms up caches and the scoped allocator's pages before anything gets counted
+        fnCall();
+        g_allocationCount = 0;
+        g_allocatedBytes = 0;
+
+        Vector<double> sampleNs;
+        for (uint32_t iteration = 0; iteration < options.iterations; ++iteration)
+        {
+            Clock::time_point start = Clock::now();
+            for (uint64_t call = 0; call < callsPerSample; ++call)
+            {
+                fnCall();
+            }
+
+            double elapsedNs = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            sampleNs.push_back(elapsedNs / double(callsPerSample));
+        }
+
+        double calls = double(callsPerSample * options.iterations);
+        double medianNs = Median(sampleNs);
+        return {
+            .schema = schema,
+            .scale = scale,
+            .operation = operation,
+            .serializedBytes = serializedBytes,
+            .medianNs = medianNs,
+            .gbPerSecond = double(serializedBytes) / medianNs,
+            .allocationsPerCall = double(g_allocationCount) / calls,
+            .allocatedBytesPerCall = double(g_allocatedBytes) / calls
+        };
+    }
+
+    template <typename T>
+    bool RunSchema(const char* schema, uint32_t scale, const T& instance, const BenchOptions& options, Vector<BenchResult>& outResults)
+    {
+        static_assert(sizeof(T) <= sizeof(g_resultSink));
+        uint64_t serializedSize = T::SerializedSize(instance);
+
+        // Aligned like loaded asset data, so views don't fall back to copying misaligned spans
+        void* buffer = TrackedAlloc(MemoryCategory::Default, serializedSize, SERIALIZED_MAX_ALIGNMENT);
+        Span<uint8_t> dest = { static_cast<uint8_t*>(buffer), serializedSize };
+
+        bool roundTrips = false;
+        {
+            MemoryScope SCOPE;
+            Serialize<T>(dest, instance);
+            roundTrips = Deserialize<T>(dest, &CountedAlloc) == instance && DeserializeView<T>(dest, &CountedAlloc) == instance;
+        }
+
+        if (!roundTrips)
+        {
+            std::fprintf(stderr, "ERROR: %s at scale %u doesn't survive a round trip\n", schema, scale);
+            TrackedFree(buffer);
+            return false;
+        }
+
+        outResults.push_back(Measure(schema, scale, "SerializedSize", serializedSize, options, [&]()
+        {
+            g_sink = g_sink + T::SerializedSize(instance);
+        }));
+
+        outResults.push_back(Measure(schema, scale, "Serialize", serializedSize, options, [&]()
+        {
+            g_sink = g_sink + Serialize<T>(dest, instance);
+        }));
+
+        outResults.push_back(Measure(schema, scale, "Deserialize", serializedSize, options, [&]()
+        {
+            MemoryScope SCOPE;
+            T deserialized = Deserialize<T>(dest, &CountedAlloc);
+            std::memcpy(g_resultSink, &deserialized, sizeof(T));
+        }));
+
+        outResults.push_back(Measure(schema, scale, "DeserializeView", serializedSize, options, [&]()
+        {
+            MemoryScope SCOPE;
+            T view = DeserializeView<T>(dest, &CountedAlloc);
+            std::memcpy(g_resultSink, &view, sizeof(T));
+        }));
+
+        TrackedFree(buffer);
+        return true;
+    }
+
+    void PrintResults(Span<const BenchResult> results)
+    {
+        std::printf("%-16s %6s %12s %-16s %12s %10s %12s %14s\n", "schema", "scale", "bytes", "operation", "median ns", "GB/s", "allocs/call", "alloc B/call");
+        for (const BenchResult& result : results)
+        {
+            std::printf("%-16s %6u %12llu %-16s %12.0f %10.3f %12.1f %14.0f\n",
+                result.schema,
+                result.scale,
+                static_cast<unsigned long long>(result.serializedBytes),
+                result.operation,
+                result.medianNs,
+                result.gbPerSecond,
+                result.allocationsPerCall,
+                result.allocatedBytesPerCall);
+        }
+    }
+
+    bool WriteJSON(std::string_view path, const BenchOptions& options, Span<const BenchResult> results)
+    {
+        char header[64];
+        int headerLength = std::snprintf(header, sizeof(header), "{\n    \"iterations\": %u,\n    \"results\": [", options.iterations);
+        String out = { header, size_t(headerLength) };
+
+        for (size_t idx = 0; idx < results.size(); ++idx)
+        {
+            const BenchResult& result = results[idx];
+
+            char buffer[512];
+            int length = std::snprintf(buffer, sizeof(buffer),
+                "%s\n        { \"schema\": \"%s\", \"scale\": %u, \"operation\": \"%s\", \"serializedBytes\": %llu, \"medianNs\": %.1f, \"gbPerSecond\": %.4f, \"allocationsPerCall\": %.2f, \"allocatedBytesPerCall\": %.1f }",
+                idx == 0 ? "" : ",",
+                result.schema,
+                result.scale,
+                result.operation,
+                static_cast<unsigned long long>(result.serializedBytes),
+                result.medianNs,
+                result.gbPerSecond,
+                result.allocationsPerCall,
+                result.allocatedBytesPerCall);
+            out.append(buffer, size_t(length));
+        }
+        out.append("\n    ]\n}\n");
+
+        String pathStr = { path.data(), path.size() };
+        FILE* outFile = nullptr;
+        fopen_s(&outFile, pathStr.c_str(), "wb");
+        if (!outFile)
+        {
+            std::fprintf(stderr, "Failed to open file for writing: '%s'\n", pathStr.c_str());
+            return false;
+        }
+
+        size_t writeSize = fwrite(out.data(), 1, out.size(), outFile);
+        fclose(outFile);
+        return writeSize == out.size();
+    }
+
+    constexpr const bench::OptionDesc OPTIONS[] = {
+        { "-iterations", "N", "Timed samples per schema, scale and operation (default 15)" },
+        { "-json", "FILE", "Where to write the results to (default luagen_bench.json)" }
+    };
+
+    bool ParseOptions(int argc, char* argv[], BenchOptions& outOptions)
+    {
+        return bench::ParseOptions(argc, argv, [&outOptions](const bench::Option& option)
+        {
+            auto [arg, param, isNumber, value] = option;
+
+            if (arg == "-iterations"sv && isNumber && value > 0)    { outOptions.iterations = uint32_t(value); }
+            else if (arg == "-json"sv)                              { outOptions.jsonPath = param; }
+            else
+            {
+                return false;
+            }
+
+            return true;
+        });
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    BenchOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        bench::PrintUsage("luagen_bench", OPTIONS);
+        return 1;
+    }
+
+    InitializeScopedAllocationForThread(DESERIALIZE_SCRATCH_SIZE);
+
+    bool succeeded = true;
+    Vector<BenchResult> results = MakeVector<BenchResult>(MemoryCategory::Default);
+    for (uint32_t scale : BENCH_SCALES)
+    {
+        InstanceStorage storage;
+        succeeded &= RunSchema("Asset", scale, MakeAsset(storage, scale), options, results);
+        succeeded &= RunSchema("Geometry", scale, MakeGeometry(storage, scale), options, results);
+        succeeded &= RunSchema("Texture", scale, MakeTexture(storage, scale), options, results);
+        succeeded &= RunSchema("MaterialShader", scale, MakeMaterialShader(storage, scale), options, results);
+    }
+
+    PrintResults(results);
+    succeeded &= WriteJSON(options.jsonPath, options, results);
+
+    TeardownScopedAllocationForThread();
+    return succeeded ? 0 : 1;
+}
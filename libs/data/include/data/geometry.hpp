@@ -105,6 +105,7 @@ namespace rn::data
         GeometryData    Build(const asset::AssetBuildDesc& desc) override;
         void            Destroy(GeometryData& data) override;
         void            Finalize() override;
+        size_t          MemoryFootprint(const GeometryData& data) override;
 
     private:
 
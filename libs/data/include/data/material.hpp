@@ -30,5 +30,6 @@ namespace rn::data
         MaterialData    Build(const asset::AssetBuildDesc& desc) override;
         void            Destroy(MaterialData& data) override;
         void            Finalize() override;
+        size_t          MemoryFootprint(const MaterialData& data) override;
     };
 }
\ No newline at end of file
@@ -124,6 +124,7 @@ namespace rn::data
         MaterialShaderData  Build(const asset::AssetBuildDesc& desc) override;
         void                Destroy(MaterialShaderData& data) override;
         void                Finalize() override;
+        size_t              MemoryFootprint(const MaterialShaderData& data) override;
 
     private:
 
@@ -89,6 +89,7 @@ namespace rn::data
         TextureData Build(const asset::AssetBuildDesc& desc) override;
         void        Destroy(TextureData& data) override;
         void        Finalize() override;
+        size_t      MemoryFootprint(const TextureData& data) override;
 
     private:
 
@@ -48,7 +48,9 @@ project "rnData"
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
     
     dependson { "basisu", "basisu_encoder" }
-    links { "rnCommon", "rnAsset", "rnRHI" }
+    links { "rnCommon", "rnAsset", "lz4", "zstd", "rnRHI" }
+
+include "bench"
 
 if BUILD_PROPERTIES.IncludeTestsInBuild then
     include "test"
@@ -43,15 +43,18 @@ GeometryPart = struct {
     field(uint32, "baseVertex"),
     field(BufferRegion, "indices"),
     field(IndexFormat, "indexFormat"),
-    field(span(Meshlet), "meshlets"),
+    -- Culling reads a member or two at a time, so every member gets its own 16 byte aligned array
+    field(soa(span(Meshlet)), "meshlets", { align = 16 }),
     field(BufferRegion, "meshletVertices"),
     field(BufferRegion, "meshletIndices")
 }
 
-Geometry = struct {
+-- The offset table lets tools read the bounds and layout without touching the vertex data
+Geometry = offset_table(struct {
     field(AABB, "aabb"),
     field(span(GeometryPart), "parts"),
     field(VertexStream, "positions"),
     field(span(VertexStream), "vertexStreams"),
-    field(span(uint8), "data")
-}
\ No newline at end of file
+    -- Copied to the GPU as a whole
+    field(span(uint8), "data", { align = 256 })
+})
\ No newline at end of file
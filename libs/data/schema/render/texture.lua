@@ -13,8 +13,9 @@ TextureUsage = enum {
     value("Heightmap"),
 }
 
-Texture = struct {
+-- The offset table lets streaming read the format and usage without touching the texture data
+Texture = offset_table(struct {
     field(TextureDataFormat, "dataFormat"),
     field(TextureUsage, "usage"),
     field(span(uint8), "data")
-}
\ No newline at end of file
+})
\ No newline at end of file
@@ -170,7 +170,7 @@ namespace rn::data
 
     GeometryData GeometryBuilder::Build(const asset::AssetBuildDesc& desc)
     {
-        schema::Geometry asset = rn::Deserialize<schema::Geometry>(desc.data, [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); });
+        schema::Geometry asset = rn::DeserializeView<schema::Geometry>(desc.data, [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); });
 
         rhi::GPUMemoryRegion dataRegion = _allocator.Allocate(uint32_t(asset.data.size()));
         uint32_t dataBufferSize = uint32_t(uint32_t(asset.data.size()));
@@ -359,6 +359,22 @@ namespace rn::data
         _device->SubmitCommandLists(submitCLs);
     }
 
+    size_t GeometryBuilder::MemoryFootprint(const GeometryData& data)
+    {
+        size_t footprint = 0;
+        if (data.dataGPURegion.allocation != rhi::GPUAllocation::Invalid)
+        {
+            footprint += data.dataGPURegion.regionSize;
+        }
+
+        if (data.blas != rhi::BLASView::Invalid)
+        {
+            footprint += data.blasGPURegion.regionSize;
+        }
+
+        return footprint;
+    }
+
     rhi::CommandList* GeometryBuilder::GetCommandListForCurrentThread()
     {
         rhi::CommandList* cl = nullptr;
@@ -143,4 +143,9 @@ namespace rn::data
         
     }
 
+    size_t MaterialBuilder::MemoryFootprint(const MaterialData& data)
+    {
+        return data.uniformData.size();
+    }
+
 }
\ No newline at end of file
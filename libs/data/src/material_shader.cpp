@@ -72,7 +72,8 @@ namespace rn::data
     {
         using namespace schema;
         MemoryScope SCOPE;
-        schema::MaterialShader asset = rn::Deserialize<schema::MaterialShader>(desc.data, [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); });
+        // Parameter groups make for many small spans, which all share a single allocation
+        schema::MaterialShader asset = rn::DeserializeViewSingleAllocation<schema::MaterialShader>(desc.data, [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); });
 
         size_t rasterPassCount = 0;
         rasterPassCount += asset.vertexRasterPasses.size();
@@ -237,4 +238,12 @@ namespace rn::data
         
     }
 
+    size_t MaterialShaderBuilder::MemoryFootprint(const MaterialShaderData& data)
+    {
+        return data.rasterPasses.size_bytes() +
+            data.rtPasses.size_bytes() +
+            data.parameters.size_bytes() +
+            data.rtLibrary.size_bytes();
+    }
+
 }
\ No newline at end of file
@@ -209,7 +209,7 @@ namespace rn::data
 
     TextureData TextureBuilder::Build(const asset::AssetBuildDesc& desc)
     {
-        schema::Texture asset = rn::Deserialize<schema::Texture>(desc.data, [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); });
+        schema::Texture asset = rn::DeserializeView<schema::Texture>(desc.data, [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); });
 
         TextureData outData = {};
 
@@ -318,6 +318,16 @@ namespace rn::data
         _device->SubmitCommandLists(submitCLs);
     }
 
+    size_t TextureBuilder::MemoryFootprint(const TextureData& data)
+    {
+        if (data.gpuRegion.allocation != rhi::GPUAllocation::Invalid)
+        {
+            return data.gpuRegion.regionSize;
+        }
+
+        return 0;
+    }
+
     rhi::CommandList* TextureBuilder::GetCommandListForCurrentThread()
     {
         rhi::CommandList* cl = nullptr;
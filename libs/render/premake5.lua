@@ -74,7 +74,7 @@ project "rnRender"
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
     
     dependson { "data_build" }
-    links { "rnCommon", "rnRHI", "rnAsset", "rnData", "rnRenderGraph", "imgui" }
+    links { "rnCommon", "rnRHI", "rnAsset", "lz4", "zstd", "rnData", "rnRenderGraph", "imgui" }
 
 if BUILD_PROPERTIES.IncludeTestsInBuild then
     include "test"
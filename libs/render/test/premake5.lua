@@ -43,4 +43,4 @@ project "renderTests"
 
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
 
-    links { "googletest", "rnCommon", "rnRHI", "rnRHID3D12", "rnAsset", "rnData", "rnRender", "rnRenderGraph", "dxgi", "WinPixEventRuntime"}
\ No newline at end of file
+    links { "googletest", "rnCommon", "rnRHI", "rnRHID3D12", "rnAsset", "lz4", "zstd", "rnData", "rnRender", "rnRenderGraph", "dxgi", "WinPixEventRuntime"}
\ No newline at end of file
@@ -44,7 +44,7 @@ project "rnScene"
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
     
     dependson { "data_build" }
-    links { "rnCommon", "rnAsset", "rnData" }
+    links { "rnCommon", "rnAsset", "lz4", "zstd", "rnData" }
 
 if BUILD_PROPERTIES.IncludeTestsInBuild then
     include "test"
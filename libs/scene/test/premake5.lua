@@ -25,4 +25,4 @@ project "sceneTests"
 
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
 
-    links { "googletest", "rnCommon", "rnAsset", "rnData" }
\ No newline at end of file
+    links { "googletest", "rnCommon", "rnAsset", "lz4", "zstd", "rnData" }
\ No newline at end of file
@@ -52,7 +52,7 @@ project "data_build"
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
 
     dependson { "dxc", "usd" }
-    links { "rnCommon", "rnAsset", "rnData", "dxcompiler", "meshoptimizer", "mikktspace", "usd_rn" }
+    links { "rnCommon", "rnAsset", "lz4", "zstd", "rnData", "dxcompiler", "meshoptimizer", "mikktspace", "usd_rn" }
 
 if BUILD_PROPERTIES.IncludeTestsInBuild then
     include "test"
@@ -4,9 +4,13 @@
 
 #include "common/memory/memory.hpp"
 #include "common/memory/vector.hpp"
+#include "common/memory/string.hpp"
 
+#include "asset/compression.hpp"
 #include "asset_gen.hpp"
 #include "luagen/schema.hpp"
+#include <algorithm>
+#include <cctype>
 #include <filesystem>
 
 namespace rn
@@ -40,6 +44,105 @@ namespace rn
         return relBuildFileDirectory / otherFile;
     }
 
+    std::string SanitizedIdentifier(const std::filesystem::path& path, const std::filesystem::path& root)
+    {
+        std::error_code err;
+        std::filesystem::path relativePath = std::filesystem::relative(path, root, err);
+        if (err)
+        {
+            return {};
+        }
+
+        // Needs to match the registry's sanitized paths: relative, forward slashes, lower case
+        std::string identifier = relativePath.generic_string();
+        std::transform(identifier.begin(), identifier.end(), identifier.begin(), [](char c)
+        {
+            return char(std::tolower(c));
+        });
+
+        return identifier;
+    }
+
+    bool CollectContentFiles(std::string_view directory, const std::filesystem::path& excludedFile, Vector<ContentFile>& outFiles)
+    {
+        std::filesystem::path contentDir = directory;
+        if (!std::filesystem::is_directory(contentDir))
+        {
+            BuildError(directory) << "Input needs to be a directory of built assets" << std::endl;
+            return false;
+        }
+
+        std::filesystem::path excludedPath = std::filesystem::absolute(excludedFile);
+
+        for (const std::filesystem::directory_entry& dirEntry : std::filesystem::recursive_directory_iterator(contentDir))
+        {
+            if (!dirEntry.is_regular_file() || std::filesystem::absolute(dirEntry.path()) == excludedPath)
+            {
+                continue;
+            }
+
+            std::string identifier = SanitizedIdentifier(dirEntry.path(), contentDir);
+            outFiles.push_back({
+                .path = dirEntry.path(),
+                .identifier = identifier,
+                .identifierHash = HashString(identifier),
+                .sizeInBytes = dirEntry.file_size()
+            });
+        }
+
+        std::sort(outFiles.begin(), outFiles.end(), [](const ContentFile& lhs, const ContentFile& rhs)
+        {
+            return lhs.identifierHash < rhs.identifierHash;
+        });
+
+        for (size_t i = 1; i < outFiles.size(); ++i)
+        {
+            if (outFiles[i].identifierHash == outFiles[i - 1].identifierHash)
+            {
+                BuildError(directory) << "Identifier hash collision between \"" << outFiles[i - 1].identifier << "\" and \"" << outFiles[i].identifier << "\"" << std::endl;
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    FILE* OpenOutputFile(std::string_view file, const std::filesystem::path& outPath, const char* mode)
+    {
+        if (outPath.has_parent_path() && !std::filesystem::is_directory(outPath.parent_path()))
+        {
+            std::filesystem::create_directories(outPath.parent_path());
+        }
+
+        FILE* outFile = nullptr;
+        fopen_s(&outFile, outPath.string().c_str(), mode);
+
+        if (!outFile)
+        {
+            BuildError(file) << "Failed to open file for writing: '" << outPath << "'" << std::endl;
+        }
+
+        return outFile;
+    }
+
+    namespace
+    {
+        // Large, streamed payloads favor decompression speed, small ones favor size on disk
+        asset::schema::AssetCompression CompressionForExtension(std::string_view extension)
+        {
+            if (extension.ends_with(".geometry") || extension.ends_with(".texture"))
+            {
+                return asset::schema::AssetCompression::LZ4;
+            }
+            else if (extension.ends_with(".material_shader"))
+            {
+                return asset::schema::AssetCompression::Zstd;
+            }
+
+            return asset::schema::AssetCompression::None;
+        }
+    }
+
     int WriteAssetToDisk(std::string_view file, std::string_view extension, const DataBuildOptions& options, Span<uint8_t> assetData, Span<std::string_view> references, Vector<std::string>& outFiles)
     {
         std::filesystem::path rootDir = options.assetRootDirectory;
@@ -61,17 +164,9 @@ namespace rn
         outFilename.replace_extension(extension);
 
         std::filesystem::path outAssetFile = options.outputDirectory / relBuildFileDirectory / outFilename;
-        if (!std::filesystem::is_directory(outAssetFile.parent_path()))
-        {
-            std::filesystem::create_directories(outAssetFile.parent_path());
-        }
-
-        FILE* outFile = nullptr;
-        fopen_s(&outFile, outAssetFile.string().c_str(), "wb");
-
+        FILE* outFile = OpenOutputFile(file, outAssetFile, "wb");
         if (!outFile)
         {
-            BuildError(file) << "Failed to open file for writing: '" << outAssetFile << "'" << std::endl;
             return 1;
         }
 
@@ -79,41 +174,64 @@ namespace rn
         sanitizedRefs.reserve(references.size());
         for (std::string_view ref : references)
         {
-            std::filesystem::path refFilePath = ref;
-            refFilePath = std::filesystem::absolute(refFilePath);
-
-            std::error_code err;
-            refFilePath = std::filesystem::relative(refFilePath, rootDir, err);
-            if (err)
+            std::string sanitizedRef = SanitizedIdentifier(std::filesystem::absolute(ref), rootDir);
+            if (sanitizedRef.empty())
             {
-                BuildError(file) << "Dependent asset \"" << refFilePath << "\" is not a descendant of the provided root path \"" << rootDir << "\"" << std::endl;
+                BuildError(file) << "Dependent asset \"" << ref << "\" is not a descendant of the provided root path \"" << rootDir << "\"" << std::endl;
+                fclose(outFile);
                 return 1;
             }
 
-            sanitizedRefs.push_back(refFilePath.string());
+            sanitizedRefs.push_back(std::move(sanitizedRef));
         }
 
         MemoryScope SCOPE;
 
         using namespace asset;
+        CompressedAssetData compressedData = CompressAssetData(assetData, CompressionForExtension(extension));
+
         schema::Asset outAsset = {
             .identifier = extension,
-            .references = { ScopedNewArray<std::string_view>(SCOPE, sanitizedRefs.size()), sanitizedRefs.size() },
-            .assetData = assetData
+            .references = { ScopedNewArray<schema::AssetReference>(SCOPE, sanitizedRefs.size()), sanitizedRefs.size() },
+            .compression = compressedData.compression,
+            .chunks = compressedData.chunks,
+            .assetData = compressedData.data
         };
 
+        // Hashing references here saves the registry from doing any string work when scheduling dependencies
         for (int refIdx = 0; const std::string& sanitizedRef : sanitizedRefs)
         {
-            outAsset.references[refIdx++] = sanitizedRef;
+            std::string_view referenceExtension = sanitizedRef;
+            size_t extOffset = referenceExtension.find_last_of('.');
+            referenceExtension = extOffset != std::string_view::npos ? referenceExtension.substr(extOffset) : std::string_view();
+
+            outAsset.references[refIdx++] = {
+                .identifierHash = HashString(sanitizedRef),
+                .extensionHash = HashString(referenceExtension),
+                .path = sanitizedRef
+            };
         }
 
-        size_t serializedSize = schema::Asset::SerializedSize(outAsset);
-        Span<uint8_t> outData = { static_cast<uint8_t*>(ScopedAlloc(serializedSize, CACHE_LINE_TARGET_SIZE)), serializedSize };
-        rn::Serialize<schema::Asset>(outData, outAsset);
+        outAsset.contentHash = HashAssetContent(extension, assetData, outAsset.references);
+
+        // Streamed, so the payload goes straight from the compressed data into the file instead of through a copy of the whole asset
+        constexpr const size_t WRITE_BUFFER_SIZE = 64 * KILO;
+        Span<uint8_t> writeBuffer = { static_cast<uint8_t*>(ScopedAlloc(WRITE_BUFFER_SIZE, CACHE_LINE_TARGET_SIZE)), WRITE_BUFFER_SIZE };
 
-        fwrite(outData.data(), 1, outData.size(), outFile);
+        bool writeSucceeded = false;
+        {
+            SerializationWriter writer(outFile, writeBuffer);
+            rn::Serialize<schema::Asset>(writer, outAsset);
+            writeSucceeded = writer.Flush();
+        }
         fclose(outFile);
 
+        if (!writeSucceeded)
+        {
+            BuildError(file) << "Failed to write file: '" << outAssetFile << "'" << std::endl;
+            return 1;
+        }
+
         outFiles.push_back(outAssetFile.string());
         return 0;
     }
@@ -139,18 +257,9 @@ namespace rn
         outFilename.replace_extension(extension);
 
         std::filesystem::path outAssetFile = options.outputDirectory / relBuildFileDirectory / outFilename;
-
-        if (!std::filesystem::is_directory(outAssetFile.parent_path()))
-        {
-            std::filesystem::create_directories(outAssetFile.parent_path());
-        }
-
-        FILE* outFile = nullptr;
-        fopen_s(&outFile, outAssetFile.string().c_str(), writeText ? "w" : "wb");
-
+        FILE* outFile = OpenOutputFile(file, outAssetFile, writeText ? "w" : "wb");
         if (!outFile)
         {
-            BuildError(file) << "Failed to open file for writing: '" << outAssetFile << "'" << std::endl;
             return 1;
         }
 
@@ -264,17 +373,9 @@ namespace rn
         auto root = toml::table();
         root.insert_or_assign("dependencies", tomlDeps);
 
-        if (!std::filesystem::is_directory(outDepFile.parent_path()))
-        {
-            std::filesystem::create_directories(outDepFile.parent_path());
-        }
-
-        FILE* outFile = nullptr;
-        fopen_s(&outFile, outDepFile.string().c_str(), "w");
-
+        FILE* outFile = OpenOutputFile(file, outDepFile, "w");
         if (!outFile)
         {
-            BuildError(file) << "Failed to open file for writing: '" << outDepFile << "'" << std::endl;
             return;
         }
 
@@ -2,9 +2,12 @@
 
 #include "common/common.hpp"
 #include "common/memory/span.hpp"
+#include "common/memory/string.hpp"
 #include "common/memory/vector.hpp"
 
+#include <cstdio>
 #include <iostream>
+#include <string>
 #include <string_view>
 #include <filesystem>
 
@@ -17,9 +20,19 @@ namespace rn
         std::string_view outputDirectory;
         std::string_view cacheDirectory;
         std::string_view assetRootDirectory;
+        std::string_view packFile;
+        std::string_view manifestFile;
         bool force;
     };
 
+    struct ContentFile
+    {
+        std::filesystem::path path;
+        std::string identifier;
+        StringHash identifierHash;
+        uint64_t sizeInBytes;
+    };
+
     std::ostream& BuildMessage(std::string_view file);
     std::ostream& BuildError(std::string_view file);
     std::ostream& BuildWarning(std::string_view file);
@@ -28,6 +41,15 @@ namespace rn
     std::filesystem::path MakeRelativeTo(std::string_view buildFile, std::string_view otherFile);
     std::filesystem::path MakeRelativeTo(std::string_view buildFile, std::wstring_view otherFile);
 
+    // Identifier the asset registry hashes for path, empty if it can't be made relative to root
+    std::string SanitizedIdentifier(const std::filesystem::path& path, const std::filesystem::path& root);
+
+    // Every file in a directory of built assets except excludedFile, sorted by identifier hash. Fails on hash collisions.
+    bool CollectContentFiles(std::string_view directory, const std::filesystem::path& excludedFile, Vector<ContentFile>& outFiles);
+
+    // Creates missing parent directories, returns nullptr after reporting the error if the file can't be opened
+    FILE* OpenOutputFile(std::string_view file, const std::filesystem::path& outPath, const char* mode);
+
     void WriteDependenciesFile(std::string_view file, const DataBuildOptions& options, Span<const std::string> dependencies);
     int WriteAssetToDisk(std::string_view file, std::string_view extension, const DataBuildOptions& options, Span<uint8_t> assetdata, Span<std::string_view> references, Vector<std::string>& outFiles);
     int WriteDataToDisk(std::string_view file, std::string_view extension, const DataBuildOptions& options, Span<uint8_t> data, bool writeText, Vector<std::string>& outFiles);
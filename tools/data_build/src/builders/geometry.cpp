@@ -660,19 +660,21 @@ namespace rn
         AppendStreamIfNotEmpty(texcoordsRegion, schema::VertexStreamType::UV, VertexStreamFormat::Float, 2, sizeof(geometry.texcoords[0]), streams);
         AppendStreamIfNotEmpty(tangentsRegion, schema::VertexStreamType::Tangent, VertexStreamFormat::Float, 4, sizeof(geometry.tangents[0]), streams);
 
-        ScopedVector<schema::Meshlet> meshlets;
+        // Meshlets are stored as structure-of-arrays, one array per member
+        ScopedVector<uint32_t> meshletVertexOffsets;
+        ScopedVector<uint32_t> meshletTriangleOffsets;
+        ScopedVector<uint32_t> meshletVertexCounts;
+        ScopedVector<uint32_t> meshletTriangleCounts;
         ScopedVector<schema::GeometryPart> parts;
         parts.reserve(geometry.parts.size());
         for (uint32_t partIdx = 0; const RawGeometryPart& part : geometry.parts)
         {
             for (const meshopt_Meshlet& meshlet : part.meshlets)
             {
-                meshlets.push_back({
-                    .vertexOffset = meshlet.vertex_offset,
-                    .triangleOffset = meshlet.triangle_offset,
-                    .vertexCount = meshlet.vertex_count,
-                    .triangleCount = meshlet.triangle_count
-                });
+                meshletVertexOffsets.push_back(meshlet.vertex_offset);
+                meshletTriangleOffsets.push_back(meshlet.triangle_offset);
+                meshletVertexCounts.push_back(meshlet.vertex_count);
+                meshletTriangleCounts.push_back(meshlet.triangle_count);
             }
         }
 
@@ -687,7 +689,12 @@ namespace rn
                 .indexFormat = part.indices16.empty() ?
                     rhi::IndexFormat::Uint32 :
                     rhi::IndexFormat::Uint16,
-                .meshlets = { meshlets.data() + meshletOffset, part.meshlets.size() },
+                .meshlets = {
+                    .vertexOffset = { meshletVertexOffsets.data() + meshletOffset, part.meshlets.size() },
+                    .triangleOffset = { meshletTriangleOffsets.data() + meshletOffset, part.meshlets.size() },
+                    .vertexCount = { meshletVertexCounts.data() + meshletOffset, part.meshlets.size() },
+                    .triangleCount = { meshletTriangleCounts.data() + meshletOffset, part.meshlets.size() }
+                },
                 .meshletVertices = regions.meshletVerticesRegion,
                 .meshletIndices = regions.meshletIndicesRegion
             });
@@ -0,0 +1,212 @@
+#include "manifest.hpp"
+
+#include "common/memory/memory.hpp"
+#include "common/memory/string.hpp"
+#include "common/memory/vector.hpp"
+#include "asset/manifest.hpp"
+#include "asset/compression.hpp"
+
+#include "asset_gen.hpp"
+#include "luagen/schema.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace rn
+{
+    namespace
+    {
+        struct ManifestInput
+        {
+            std::string identifier;
+            asset::ManifestEntry entry;
+            Vector<StringHash> references;
+        };
+
+        bool ReadFile(const std::filesystem::path& file, Vector<uint8_t>& outData)
+        {
+            FILE* inFile = nullptr;
+            fopen_s(&inFile, file.string().c_str(), "rb");
+            if (!inFile)
+            {
+                return false;
+            }
+
+            outData.resize(std::filesystem::file_size(file));
+            size_t readSize = fread(outData.data(), 1, outData.size(), inFile);
+            fclose(inFile);
+
+            return readSize == outData.size();
+        }
+
+        // Built assets store their extension as identifier, anything else in the directory isn't an asset
+        bool IsAssetFile(Span<const uint8_t> data, std::string_view identifier)
+        {
+            return asset::IsValidAssetFile(data) && identifier.ends_with(asset::schema::Asset::Accessor(data).identifier());
+        }
+    }
+
+    int DoBuildManifest(std::string_view directory, const DataBuildOptions& options)
+    {
+        std::filesystem::path manifestPath = std::filesystem::absolute(options.manifestFile);
+
+        Vector<ContentFile> contentFiles;
+        if (!CollectContentFiles(directory, manifestPath, contentFiles))
+        {
+            return 1;
+        }
+
+        // Stays sorted by identifier hash, content files which aren't assets only get skipped
+        Vector<ManifestInput> inputs;
+        Vector<uint8_t> fileData;
+        for (const ContentFile& contentFile : contentFiles)
+        {
+            if (!ReadFile(contentFile.path, fileData))
+            {
+                BuildError(directory) << "Failed to read file: '" << contentFile.path << "'" << std::endl;
+                return 1;
+            }
+
+            if (!IsAssetFile(fileData, contentFile.identifier))
+            {
+                continue;
+            }
+
+            MemoryScope SCOPE;
+            auto fnAlloc = [](size_t size) { return ScopedAlloc(size, CACHE_LINE_TARGET_SIZE); };
+            const asset::schema::Asset asset = rn::DeserializeView<asset::schema::Asset>(fileData, fnAlloc);
+
+            // Compressed assets only store the uncompressed size per chunk
+            uint64_t dataSize = asset.assetData.size();
+            if (asset.compression != asset::schema::AssetCompression::None)
+            {
+                dataSize = 0;
+                for (const asset::schema::CompressedChunk& chunk : asset.chunks)
+                {
+                    dataSize += chunk.uncompressedSize;
+                }
+            }
+
+            ManifestInput& input = inputs.emplace_back();
+            input.identifier = contentFile.identifier;
+            input.entry = {
+                .identifierHash = contentFile.identifierHash,
+                .extensionHash = HashString(asset.identifier),
+                .fileSizeInBytes = fileData.size(),
+                .dataSizeInBytes = dataSize
+            };
+
+            for (const asset::schema::AssetReference& reference : asset.references)
+            {
+                input.references.push_back(reference.identifierHash);
+            }
+        }
+
+        auto fnFindInput = [&inputs](StringHash identifierHash) -> uint32_t
+        {
+            auto it = std::lower_bound(inputs.begin(), inputs.end(), identifierHash, [](const ManifestInput& input, StringHash hash)
+            {
+                return input.entry.identifierHash < hash;
+            });
+
+            return (it != inputs.end() && it->entry.identifierHash == identifierHash) ? uint32_t(it - inputs.begin()) : UINT32_MAX;
+        };
+
+        // Post-order traversal of each asset's references puts dependencies before their dependents
+        enum class VisitState : uint8_t
+        {
+            Unvisited,
+            Visiting,
+            Visited
+        };
+
+        Vector<uint32_t> closureIndices;
+        Vector<VisitState> visitStates(inputs.size(), VisitState::Unvisited);
+        bool foundCycle = false;
+        auto fnVisit = [&](uint32_t inputIdx, auto& fnRecurse) -> void
+        {
+            if (visitStates[inputIdx] == VisitState::Visited)
+            {
+                return;
+            }
+
+            if (visitStates[inputIdx] == VisitState::Visiting)
+            {
+                BuildError(directory) << "Circular reference through \"" << inputs[inputIdx].identifier << "\"" << std::endl;
+                foundCycle = true;
+                return;
+            }
+
+            visitStates[inputIdx] = VisitState::Visiting;
+            for (StringHash reference : inputs[inputIdx].references)
+            {
+                uint32_t referenceIdx = fnFindInput(reference);
+                if (referenceIdx == UINT32_MAX)
+                {
+                    // The registry discovers references missing from the manifest on its own, at the cost of an extra round trip
+                    BuildWarning(directory) << "\"" << inputs[inputIdx].identifier << "\" references an asset which isn't in the content directory" << std::endl;
+                    continue;
+                }
+
+                fnRecurse(referenceIdx, fnRecurse);
+            }
+
+            visitStates[inputIdx] = VisitState::Visited;
+            closureIndices.push_back(inputIdx);
+        };
+
+        uint64_t pathSize = 0;
+        for (uint32_t inputIdx = 0; inputIdx < uint32_t(inputs.size()); ++inputIdx)
+        {
+            ManifestInput& input = inputs[inputIdx];
+            input.entry.closureOffset = uint32_t(closureIndices.size());
+
+            fnVisit(inputIdx, fnVisit);
+
+            input.entry.closureCount = uint32_t(closureIndices.size()) - input.entry.closureOffset;
+            for (uint32_t closureIdx = input.entry.closureOffset; closureIdx < closureIndices.size(); ++closureIdx)
+            {
+                visitStates[closureIndices[closureIdx]] = VisitState::Unvisited;
+            }
+            input.entry.pathOffset = uint32_t(pathSize);
+            input.entry.pathLength = uint32_t(input.identifier.size());
+            pathSize += input.identifier.size();
+        }
+
+        if (foundCycle)
+        {
+            return 1;
+        }
+
+        FILE* outFile = OpenOutputFile(directory, manifestPath, "wb");
+        if (!outFile)
+        {
+            return 1;
+        }
+
+        asset::ManifestHeader header = {
+            .magic = asset::MANIFEST_MAGIC,
+            .version = asset::MANIFEST_VERSION,
+            .entryCount = inputs.size(),
+            .closureIndexCount = closureIndices.size(),
+            .pathSizeInBytes = pathSize
+        };
+
+        fwrite(&header, sizeof(header), 1, outFile);
+        for (const ManifestInput& input : inputs)
+        {
+            fwrite(&input.entry, sizeof(input.entry), 1, outFile);
+        }
+
+        fwrite(closureIndices.data(), sizeof(uint32_t), closureIndices.size(), outFile);
+        for (const ManifestInput& input : inputs)
+        {
+            fwrite(input.identifier.data(), 1, input.identifier.size(), outFile);
+        }
+
+        fclose(outFile);
+
+        BuildMessage(directory) << "Wrote reference closures of " << inputs.size() << " asset(s) to " << manifestPath << std::endl;
+        return 0;
+    }
+}
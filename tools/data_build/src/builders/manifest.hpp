@@ -0,0 +1,9 @@
+#pragma once
+
+#include "build.hpp"
+#include <string_view>
+
+namespace rn
+{
+    int DoBuildManifest(std::string_view directory, const DataBuildOptions& options);
+}
@@ -0,0 +1,107 @@
+#include "pack.hpp"
+
+#include "common/memory/string.hpp"
+#include "common/memory/vector.hpp"
+#include "asset/pack.hpp"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace rn
+{
+    namespace
+    {
+        void WritePadding(FILE* outFile, uint64_t& offset, uint64_t alignment)
+        {
+            constexpr const uint8_t ZEROES[256] = {};
+
+            uint64_t alignedOffset = AlignSize(offset, alignment);
+            while (offset < alignedOffset)
+            {
+                uint64_t writeSize = std::min(alignedOffset - offset, uint64_t(sizeof(ZEROES)));
+                fwrite(ZEROES, 1, writeSize, outFile);
+                offset += writeSize;
+            }
+        }
+    }
+
+    int DoBuildPack(std::string_view directory, const DataBuildOptions& options)
+    {
+        std::filesystem::path packPath = std::filesystem::absolute(options.packFile);
+
+        Vector<ContentFile> inputs;
+        if (!CollectContentFiles(directory, packPath, inputs))
+        {
+            return 1;
+        }
+
+        Vector<asset::PackEntry> entries;
+        entries.reserve(inputs.size());
+
+        uint64_t offset = AlignSize(sizeof(asset::PackHeader) + inputs.size() * sizeof(asset::PackEntry), asset::PACK_BLOB_ALIGNMENT);
+        for (const ContentFile& input : inputs)
+        {
+            entries.push_back({
+                .identifierHash = input.identifierHash,
+                .offsetInBytes = offset,
+                .sizeInBytes = input.sizeInBytes
+            });
+
+            offset = AlignSize(offset + input.sizeInBytes, asset::PACK_BLOB_ALIGNMENT);
+        }
+
+        FILE* outFile = OpenOutputFile(directory, packPath, "wb");
+        if (!outFile)
+        {
+            return 1;
+        }
+
+        asset::PackHeader header = {
+            .magic = asset::PACK_MAGIC,
+            .version = asset::PACK_VERSION,
+            .entryCount = inputs.size(),
+            .blobAlignment = asset::PACK_BLOB_ALIGNMENT
+        };
+
+        uint64_t writeOffset = 0;
+        fwrite(&header, sizeof(header), 1, outFile);
+        writeOffset += sizeof(header);
+
+        fwrite(entries.data(), sizeof(asset::PackEntry), entries.size(), outFile);
+        writeOffset += entries.size() * sizeof(asset::PackEntry);
+
+        Vector<uint8_t> fileData;
+        for (const ContentFile& input : inputs)
+        {
+            WritePadding(outFile, writeOffset, asset::PACK_BLOB_ALIGNMENT);
+
+            FILE* inFile = nullptr;
+            fopen_s(&inFile, input.path.string().c_str(), "rb");
+            if (!inFile)
+            {
+                BuildError(directory) << "Failed to open file for reading: '" << input.path << "'" << std::endl;
+                fclose(outFile);
+                return 1;
+            }
+
+            fileData.resize(input.sizeInBytes);
+            size_t readSize = fread(fileData.data(), 1, fileData.size(), inFile);
+            fclose(inFile);
+
+            if (readSize != fileData.size())
+            {
+                BuildError(directory) << "Failed to read file: '" << input.path << "'" << std::endl;
+                fclose(outFile);
+                return 1;
+            }
+
+            fwrite(fileData.data(), 1, fileData.size(), outFile);
+            writeOffset += fileData.size();
+        }
+
+        fclose(outFile);
+
+        BuildMessage(directory) << "Packed " << inputs.size() << " asset(s) into " << packPath << std::endl;
+        return 0;
+    }
+}
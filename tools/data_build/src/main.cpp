@@ -6,6 +6,8 @@
 #include "common/memory/vector.hpp"
 
 #include "builders/build.hpp"
+#include "builders/pack.hpp"
+#include "builders/manifest.hpp"
 
 namespace rn
 {
@@ -13,7 +15,10 @@ namespace rn
         .name = "data_build"sv,
         .additionalUsageText = 
             "FILE must be an asset build file in TOML format or a USD file (usda, usdc or usd).\n"
-            "Example: data_build -o .\\Content .\\textures\\my_texture.texture.toml\n"sv
+            "When building a pack or a manifest, FILE must be a directory containing built assets.\n"
+            "Example: data_build -o .\\Content .\\textures\\my_texture.texture.toml\n"
+            "Example: data_build -pack .\\content.pack .\\Content\n"
+            "Example: data_build -manifest .\\content.manifest .\\Content\n"sv
     };
 
     void OnHelpOption(DataBuildOptions&, std::string_view);
@@ -42,6 +47,18 @@ namespace rn
             .description = "Root directory for the asset file structure, used to determine relative paths in the cache"sv,
             .onOptionFound = [](DataBuildOptions& args, std::string_view arg){ args.assetRootDirectory = arg; }
         },
+        {
+            .option = "pack"sv,
+            .parameter = "PACK_FILE"sv,
+            .description = "Bundles all built assets in the input directory into a single pack file."sv,
+            .onOptionFound = [](DataBuildOptions& args, std::string_view arg){ args.packFile = arg; }
+        },
+        {
+            .option = "manifest"sv,
+            .parameter = "MANIFEST_FILE"sv,
+            .description = "Writes the reference closures of all built assets in the input directory to a manifest file."sv,
+            .onOptionFound = [](DataBuildOptions& args, std::string_view arg){ args.manifestFile = arg; }
+        },
         { 
             .option = "h"sv,
             .description = "Print this usage text"sv,
@@ -65,13 +82,26 @@ int main(int argc, char* argv[])
         .exeName = argv[0],
         .outputDirectory = ""sv,
         .cacheDirectory = "build/data_cache"sv,
-        .assetRootDirectory = "./"sv
+        .assetRootDirectory = "./"sv,
+        .packFile = ""sv,
+        .manifestFile = ""sv
     };
 
     int ret = 1;
     if (ParseArgs<rn::DataBuildOptions>(rn::DATA_BUILD_TOOL, options, file, rn::OPTIONS, argc, argv))
     {
-        ret = rn::DoBuild(file, options);
+        if (!options.packFile.empty())
+        {
+            ret = rn::DoBuildPack(file, options);
+        }
+        else if (!options.manifestFile.empty())
+        {
+            ret = rn::DoBuildManifest(file, options);
+        }
+        else
+        {
+            ret = rn::DoBuild(file, options);
+        }
     }
 
     rn::TeardownScopedAllocationForThread();
@@ -33,6 +33,11 @@ project "data_build_tests"
         "IF not exist \"%{wks.location}%{cfg.buildcfg}\\python\" (mklink /d \"%{wks.location}%{cfg.buildcfg}\\python\" \"" .. OPENUSD_BUILD_PATH .. "/%{cfg.buildcfg}/lib/python\")" 
     }
 
+    -- Runs the manifest step over everything the asset build commands below wrote, so manifest.cpp tests real data_build output
+    postbuildcommands {
+        "%{wks.location}%{cfg.buildcfg}\\data_build.exe -manifest " .. GENERATED_FILE_PATH .. "/data_build_tests/content.manifest " .. GENERATED_FILE_PATH .. "/data_build_tests"
+    }
+
     filter "files:**.usda or **.usdc or **.usd"
         buildmessage ""
         buildcommands {
@@ -52,4 +57,4 @@ project "data_build_tests"
     targetdir "%{wks.location}/%{cfg.buildcfg}/"
 
     dependson { "data_build" }
-    links { "googletest", "rnCommon", "rnAsset", "rnData", "rnRHI", "rnRHID3D12", "dxgi", "WinPixEventRuntime" }
\ No newline at end of file
+    links { "googletest", "rnCommon", "rnAsset", "lz4", "zstd", "rnData", "rnRHI", "rnRHID3D12", "dxgi", "WinPixEventRuntime" }
\ No newline at end of file
@@ -10,12 +10,6 @@ using namespace rn;
 
 TEST(DataBuildTests_Geometry, IntegrationTest_Monkey)
 {
-    asset::Registry registry({
-        .contentPrefix = "gen/data_build_tests/",
-        .enableMultithreadedLoad = true,
-        .onMapAsset = asset::MapFileAsset
-    });
-
     rhi::Device* device = rhi::CreateD3D12Device({
             .adapterIndex = 0,
             .enableDebugLayer = true
@@ -23,6 +17,12 @@ TEST(DataBuildTests_Geometry, IntegrationTest_Monkey)
         rhi::DefaultDeviceMemorySettings());
 
     data::GeometryBuilder geometryBuilder(device);
+    asset::Registry registry({
+        .contentPrefix = "gen/data_build_tests/",
+        .enableMultithreadedLoad = true,
+        .onMapAsset = asset::MapFileAsset
+    });
+
     registry.RegisterAssetType<data::Geometry, data::GeometryData>({
         .identifierHash = HashString(".geometry"),
         .initialCapacity = 32,
@@ -59,12 +59,6 @@ TEST(DataBuildTests_Geometry, IntegrationTest_Monkey)
 
 TEST(DataBuildTests_Geometry, IntegrationTest_CubeSphere)
 {
-    asset::Registry registry({
-        .contentPrefix = "gen/data_build_tests/",
-        .enableMultithreadedLoad = true,
-        .onMapAsset = asset::MapFileAsset
-    });
-
     rhi::Device* device = rhi::CreateD3D12Device({
             .adapterIndex = 0,
             .enableDebugLayer = true
@@ -72,6 +66,12 @@ TEST(DataBuildTests_Geometry, IntegrationTest_CubeSphere)
         rhi::DefaultDeviceMemorySettings());
 
     data::GeometryBuilder geometryBuilder(device);
+    asset::Registry registry({
+        .contentPrefix = "gen/data_build_tests/",
+        .enableMultithreadedLoad = true,
+        .onMapAsset = asset::MapFileAsset
+    });
+
     registry.RegisterAssetType<data::Geometry, data::GeometryData>({
         .identifierHash = HashString(".geometry"),
         .initialCapacity = 32,
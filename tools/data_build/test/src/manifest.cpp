@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+
+#include "asset/manifest.hpp"
+
+#include <algorithm>
+
+using namespace rn;
+
+namespace
+{
+    bool ClosureContains(const asset::Manifest& manifest, const asset::ManifestEntry& entry, std::string_view path)
+    {
+        Span<const uint32_t> closure = manifest.Closure(entry);
+        return std::any_of(closure.begin(), closure.end(), [&manifest, path](uint32_t entryIdx)
+        {
+            return manifest.Path(manifest.Entry(entryIdx)) == path;
+        });
+    }
+}
+
+// The manifest is written by the data_build_tests post-build step, from the assets the test build commands wrote
+TEST(DataBuildTests_Manifest, IntegrationTest_Manifest)
+{
+    asset::Manifest manifest("gen/data_build_tests/content.manifest");
+    ASSERT_TRUE(manifest.IsValid());
+
+    const asset::ManifestEntry* texture = manifest.Find(HashString("textures/texture.texture"));
+    ASSERT_NE(texture, nullptr);
+    EXPECT_EQ(texture->extensionHash, HashString(".texture"));
+    EXPECT_EQ(manifest.Path(*texture), "textures/texture.texture");
+    EXPECT_GT(texture->fileSizeInBytes, 0);
+    EXPECT_GT(texture->dataSizeInBytes, 0);
+
+    const asset::ManifestEntry* shader = manifest.Find(HashString("material_shaders/material_shader.material_shader"));
+    ASSERT_NE(shader, nullptr);
+    EXPECT_EQ(shader->extensionHash, HashString(".material_shader"));
+
+    const asset::ManifestEntry* geometry = manifest.Find(HashString("geometry/monkey.suzanne.geometry"));
+    ASSERT_NE(geometry, nullptr);
+    EXPECT_EQ(geometry->extensionHash, HashString(".geometry"));
+
+    // Closures end with the asset itself, after all of its transitive references
+    const asset::ManifestEntry* material = manifest.Find(HashString("materials/material.material"));
+    ASSERT_NE(material, nullptr);
+    EXPECT_EQ(material->extensionHash, HashString(".material"));
+
+    Span<const uint32_t> closure = manifest.Closure(*material);
+    ASSERT_FALSE(closure.empty());
+    EXPECT_EQ(&manifest.Entry(closure.back()), material);
+    EXPECT_TRUE(ClosureContains(manifest, *material, "textures/texture.texture"));
+    EXPECT_TRUE(ClosureContains(manifest, *material, "material_shaders/material_shader.material_shader"));
+
+    // Dependency files in the build cache aren't assets
+    EXPECT_EQ(manifest.Find(HashString("cache/textures/texture.toml")), nullptr);
+}
\ No newline at end of file
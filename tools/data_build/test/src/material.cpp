@@ -13,12 +13,6 @@ using namespace rn;
 
 TEST(DataBuildTests_Material, IntegrationTest_Material)
 {
-    asset::Registry registry({
-        .contentPrefix = "gen/data_build_tests/",
-        .enableMultithreadedLoad = true,
-        .onMapAsset = asset::MapFileAsset
-    });
-
     rhi::Device* device = rhi::CreateD3D12Device({
             .adapterIndex = 0,
             .enableDebugLayer = true
@@ -26,20 +20,26 @@ TEST(DataBuildTests_Material, IntegrationTest_Material)
         rhi::DefaultDeviceMemorySettings());
 
     data::TextureBuilder textureBuilder(device);
+    data::MaterialShaderBuilder shaderBuilder(device);
+    data::MaterialBuilder materialBuilder;
+    asset::Registry registry({
+        .contentPrefix = "gen/data_build_tests/",
+        .enableMultithreadedLoad = true,
+        .onMapAsset = asset::MapFileAsset
+    });
+
     registry.RegisterAssetType<data::Texture, data::TextureData>({
         .identifierHash = HashString(".texture"),
         .initialCapacity = 32,
         .builder = &textureBuilder
     });
 
-    data::MaterialShaderBuilder shaderBuilder(device);
     registry.RegisterAssetType<data::MaterialShader, data::MaterialShaderData>({
         .identifierHash = HashString(".material_shader"),
         .initialCapacity = 32,
         .builder = &shaderBuilder
     });
 
-    data::MaterialBuilder materialBuilder;
     registry.RegisterAssetType<data::Material, data::MaterialData>({
         .identifierHash = HashString(".material"),
         .initialCapacity = 32,
@@ -12,12 +12,6 @@ using namespace rn;
 
 TEST(DataBuildTests_MaterialShader, IntegrationTest_MaterialShader)
 {
-    asset::Registry registry({
-        .contentPrefix = "gen/data_build_tests/",
-        .enableMultithreadedLoad = true,
-        .onMapAsset = asset::MapFileAsset
-    });
-
     rhi::Device* device = rhi::CreateD3D12Device({
             .adapterIndex = 0,
             .enableDebugLayer = true
@@ -26,13 +20,19 @@ TEST(DataBuildTests_MaterialShader, IntegrationTest_MaterialShader)
 
     // Need a texture builder to handle dependencies!
     data::TextureBuilder textureBuilder(device);
+    data::MaterialShaderBuilder shaderBuilder(device);
+    asset::Registry registry({
+        .contentPrefix = "gen/data_build_tests/",
+        .enableMultithreadedLoad = true,
+        .onMapAsset = asset::MapFileAsset
+    });
+
     registry.RegisterAssetType<data::Texture, data::TextureData>({
         .identifierHash = HashString(".texture"),
         .initialCapacity = 32,
         .builder = &textureBuilder
     });
 
-    data::MaterialShaderBuilder shaderBuilder(device);
     registry.RegisterAssetType<data::MaterialShader, data::MaterialShaderData>({
         .identifierHash = HashString(".material_shader"),
         .initialCapacity = 32,
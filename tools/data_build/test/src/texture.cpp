@@ -11,12 +11,6 @@ using namespace rn;
 
 TEST(DataBuildTests_Texture, IntegrationTest_Texture)
 {
-    asset::Registry registry({
-        .contentPrefix = "gen/data_build_tests/",
-        .enableMultithreadedLoad = true,
-        .onMapAsset = asset::MapFileAsset
-    });
-
     rhi::Device* device = rhi::CreateD3D12Device({
             .adapterIndex = 0,
             .enableDebugLayer = true
@@ -24,6 +18,12 @@ TEST(DataBuildTests_Texture, IntegrationTest_Texture)
         rhi::DefaultDeviceMemorySettings());
 
     data::TextureBuilder textureBuilder(device);
+    asset::Registry registry({
+        .contentPrefix = "gen/data_build_tests/",
+        .enableMultithreadedLoad = true,
+        .onMapAsset = asset::MapFileAsset
+    });
+
     registry.RegisterAssetType<data::Texture, data::TextureData>({
         .identifierHash = HashString(".texture"),
         .initialCapacity = 32,
@@ -1,7 +1,10 @@
 #pragma once
 
+#include "common/memory/hash.hpp"
 #include "common/memory/span.hpp"
+#include <cstddef>
 #include <cstdint>
+#include <cstdio>
 #include <string_view>
 #include <type_traits>
 #include <iostream>
@@ -30,41 +33,129 @@ namespace rn
 
         template <typename T>
         constexpr bool IsStringViewV = IsStringView<T>::value;
+
+        // Types whose in-memory representation is exactly their serialized bytes, no padding included
+        template <typename T>
+        constexpr bool IsBulkSerializable()
+        {
+            if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+            {
+                return true;
+            }
+            else if constexpr (requires { T::FixedSerializedSize; })
+            {
+                return std::is_trivially_copyable_v<T> && sizeof(T) == T::FixedSerializedSize;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        template <typename T>
+        constexpr bool IsBulkSerializableV = IsBulkSerializable<std::remove_cv_t<T>>();
+
+        // Generated structure-of-arrays views, which serialize like spans of their element type and take an alignment too
+        template <typename T>
+        constexpr bool IsStructureOfArraysV = requires { typename T::ElementType; };
+
+        // Schema structs, as opposed to the structure-of-arrays views generated for spans of them
+        template <typename T>
+        constexpr bool IsSchemaStructV = std::is_aggregate_v<T> && !IsStructureOfArraysV<T>;
+
+        // Span elements without an alignment from the schema are aligned for their type, so views can point at them
+        template <typename T>
+        constexpr uint64_t SpanAlignment(uint64_t alignment)
+        {
+            if (alignment > 0)
+            {
+                return alignment;
+            }
+
+            return IsBulkSerializableV<T> ? alignof(T) : 1;
+        }
     }
 
     constexpr const uint64_t SERIALIZED_SPAN_SIZE = sizeof(uint64_t);
 
+    // Alignments are relative to the start of the serialized data. Buffers holding serialized data need to be aligned
+    // to this for aligned offsets to make for aligned addresses, which is the largest alignment a schema may ask for.
+    constexpr const uint64_t SERIALIZED_MAX_ALIGNMENT = 512;
+
+    // Structs with offset tables start with the offset of each of their fields, relative to the start of the struct
+    constexpr const uint64_t SERIALIZED_FIELD_OFFSET_SIZE = sizeof(uint64_t);
+
 
     template <typename T>
     requires std::is_arithmetic_v<T> || std::is_enum_v<T>
-    uint64_t SerializedSize(const T& v)
+    uint64_t SerializedSize(const T& v, uint64_t offset = 0)
     {
         return sizeof(T);
     }
 
     template <typename T>
-    requires std::is_aggregate_v<T>
-    uint64_t SerializedSize(const T& v)
+    requires internal::IsSchemaStructV<T>
+    uint64_t SerializedSize(const T& v, uint64_t offset = 0)
     {
-        return T::SerializedSize(v);
+        if constexpr (requires { T::FixedSerializedSize; })
+        {
+            return T::FixedSerializedSize;
+        }
+        else
+        {
+            return T::SerializedSize(v, offset);
+        }
     }
 
-    inline uint64_t SerializedSize(const std::string_view& v)
+    inline uint64_t SerializedSize(const std::string_view& v, uint64_t offset = 0)
     {
         return SERIALIZED_SPAN_SIZE + v.size();
     }
 
+    // Arrays of bulk serializable types, without the element count in front of them. Spans store a count per array,
+    // structure-of-arrays views a single one for all of their arrays.
+    template <typename T>
+    uint64_t SerializedArraySize(uint64_t count, uint64_t offset, uint64_t alignment = 0)
+    {
+        static_assert(internal::IsBulkSerializableV<T>);
+        return AlignSize(offset, internal::SpanAlignment<T>(alignment)) - offset + count * sizeof(T);
+    }
+
     template <typename T>
     requires internal::IsSpanV<T>
-    uint64_t SerializedSize(const T& v)
+    uint64_t SerializedSize(const T& v, uint64_t offset = 0, uint64_t alignment = 0)
     {
-        uint64_t size = SERIALIZED_SPAN_SIZE;
-        for (const auto& e : v)
+        using ValueType = typename T::value_type;
+        if constexpr (internal::IsBulkSerializableV<ValueType>)
+        {
+            return SERIALIZED_SPAN_SIZE + SerializedArraySize<ValueType>(v.size(), offset + SERIALIZED_SPAN_SIZE, alignment);
+        }
+        else
         {
-            size += SerializedSize(e);
+            uint64_t elementsOffset = AlignSize(offset + SERIALIZED_SPAN_SIZE, internal::SpanAlignment<ValueType>(alignment));
+            if constexpr (requires { ValueType::FixedSerializedSize; })
+            {
+                // Fixed size types hold no spans, so there's no padding between elements either
+                return elementsOffset - offset + v.size() * ValueType::FixedSerializedSize;
+            }
+            else
+            {
+                uint64_t size = elementsOffset - offset;
+                for (const auto& e : v)
+                {
+                    size += SerializedSize(e, offset + size);
+                }
+
+                return size;
+            }
         }
+    }
 
-        return size;
+    template <typename T>
+    requires internal::IsStructureOfArraysV<T>
+    uint64_t SerializedSize(const T& v, uint64_t offset = 0, uint64_t alignment = 0)
+    {
+        return T::SerializedSize(v, offset, alignment);
     }
 
 
@@ -77,6 +168,33 @@ namespace rn
         return sizeof(T);
     }
 
+    namespace internal
+    {
+        inline uint64_t SerializePadding(const Span<uint8_t> dest, uint64_t& offset, uint64_t alignment)
+        {
+            // Padding is zeroed, identical data needs to serialize to identical bytes
+            uint64_t padding = AlignSize(offset, alignment) - offset;
+            RN_ASSERT(dest.size_bytes() - offset >= padding);
+            std::memset(dest.data() + offset, 0, padding);
+            offset += padding;
+            return padding;
+        }
+    }
+
+    template <typename T>
+    requires internal::IsSpanV<T>
+    uint64_t SerializeArray(const Span<uint8_t> dest, uint64_t& offset, const T& v, uint64_t alignment = 0)
+    {
+        using ValueType = typename T::value_type;
+        static_assert(internal::IsBulkSerializableV<ValueType>);
+
+        uint64_t padding = internal::SerializePadding(dest, offset, internal::SpanAlignment<ValueType>(alignment));
+        RN_ASSERT(dest.size_bytes() - offset >= v.size_bytes());
+        std::memcpy(dest.data() + offset, v.data(), v.size_bytes());
+        offset += v.size_bytes();
+        return padding + v.size_bytes();
+    }
+
     template <typename T>
     requires std::is_arithmetic_v<T> || std::is_enum_v<T>
     uint64_t Serialize(const Span<uint8_t> dest, uint64_t& offset, const T& v)
@@ -85,7 +203,7 @@ namespace rn
     }
 
     template <typename T>
-    requires std::is_aggregate_v<T>
+    requires internal::IsSchemaStructV<T>
     uint64_t Serialize(const Span<uint8_t> dest, uint64_t& offset, const T& v)
     {
         uint64_t val = T::Serialize(v, offset, dest);
@@ -96,40 +214,195 @@ namespace rn
     {
         // Write where we will find the span/string data, followed by the amount of elements
         uint64_t size = SerializeDirect(dest, offset, uint64_t(v.size()));
+        RN_ASSERT(dest.size_bytes() - offset >= v.size());
         std::memcpy(dest.data() + offset, v.data(), v.size());
         size += v.size();
         offset += v.size();
         return size;
     }
 
-    inline uint64_t Serialize(const Span<uint8_t> dest, uint64_t& offset, const Span<uint8_t>& v)
+    template <typename T>
+    requires internal::IsSpanV<T>
+    uint64_t Serialize(const Span<uint8_t> dest, uint64_t& offset, const T& v, uint64_t alignment = 0)
     {
         // Write where we will find the span/string data, followed by the amount of elements
         uint64_t size = SerializeDirect(dest, offset, uint64_t(v.size()));
-        std::memcpy(dest.data() + offset, v.data(), v.size());
-        size += v.size();
-        offset += v.size();
-        return size;
+        if constexpr (internal::IsBulkSerializableV<typename T::value_type>)
+        {
+            return size + SerializeArray(dest, offset, v, alignment);
+        }
+        else
+        {
+            size += internal::SerializePadding(dest, offset, internal::SpanAlignment<typename T::value_type>(alignment));
+
+            // Write elements/characters to the tail
+            for (const auto& e : v)
+            {
+                uint64_t elementSize = Serialize(dest, offset, e);
+                size += elementSize;
+            }
+            return size;
+        }
+    }
+
+    template <typename T>
+    requires internal::IsStructureOfArraysV<T>
+    uint64_t Serialize(const Span<uint8_t> dest, uint64_t& offset, const T& v, uint64_t alignment = 0)
+    {
+        return T::Serialize(v, offset, dest, alignment);
     }
 
+    template <typename T>
+    uint64_t Serialize(const Span<uint8_t> dest, const T& v)
+    {
+        uint64_t offset = 0;
+        return Serialize<T>(dest, offset, v);
+    }
+
+    // Serializes straight into a file or pipe in a single pass, without sizing the data or holding all of it in memory first.
+    // Small writes are gathered in the provided buffer, large spans get written straight out of their own memory.
+    class SerializationWriter
+    {
+    public:
+
+        SerializationWriter(FILE* file, Span<uint8_t> buffer)
+            : _file(file)
+            , _buffer(buffer)
+        {
+            // Padding is written through the buffer
+            RN_ASSERT(buffer.size() >= SERIALIZED_MAX_ALIGNMENT);
+        }
+
+        ~SerializationWriter()
+        {
+            Flush();
+        }
+
+        void Write(const void* data, uint64_t size)
+        {
+            _bytesWritten += size;
+            if (size > _buffer.size() - _bufferedSize)
+            {
+                Flush();
+            }
+
+            // Copying large writes into the buffer would only add a copy to a write the file sees as a whole anyway
+            if (size >= _buffer.size() / 2)
+            {
+                WriteToFile(data, size);
+                return;
+            }
+
+            std::memcpy(_buffer.data() + _bufferedSize, data, size);
+            _bufferedSize += size;
+        }
+
+        void WriteZeroes(uint64_t size)
+        {
+            _bytesWritten += size;
+            if (size > _buffer.size() - _bufferedSize)
+            {
+                Flush();
+            }
+
+            RN_ASSERT(size <= _buffer.size());
+            std::memset(_buffer.data() + _bufferedSize, 0, size);
+            _bufferedSize += size;
+        }
+
+        // Returns false when any write so far has failed
+        bool Flush()
+        {
+            if (_bufferedSize > 0)
+            {
+                WriteToFile(_buffer.data(), _bufferedSize);
+                _bufferedSize = 0;
+            }
+
+            return !_failed;
+        }
+
+        uint64_t BytesWritten() const { return _bytesWritten; }
+
+    private:
+
+        void WriteToFile(const void* data, uint64_t size)
+        {
+            _failed |= std::fwrite(data, 1, size, _file) != size;
+        }
+
+        FILE* _file;
+        Span<uint8_t> _buffer;
+        uint64_t _bufferedSize = 0;
+        uint64_t _bytesWritten = 0;
+        bool _failed = false;
+    };
+
+    // Mirrors the Span overloads. Offsets still count from the start of the serialized data, which is where alignments apply.
     template <typename T>
     requires internal::IsSpanV<T>
-    uint64_t Serialize(const Span<uint8_t> dest, uint64_t& offset, const T& v)
+    uint64_t SerializeArray(SerializationWriter& dest, uint64_t& offset, const T& v, uint64_t alignment = 0)
     {
-        // Write where we will find the span/string data, followed by the amount of elements
-        uint64_t size = SerializeDirect(dest, offset, uint64_t(v.size()));
+        using ValueType = typename T::value_type;
+        static_assert(internal::IsBulkSerializableV<ValueType>);
 
-        // Write elements/characters to the tail   
-        for (const auto& e : v)
+        uint64_t padding = AlignSize(offset, internal::SpanAlignment<ValueType>(alignment)) - offset;
+        dest.WriteZeroes(padding);
+        dest.Write(v.data(), v.size_bytes());
+        offset += padding + v.size_bytes();
+        return padding + v.size_bytes();
+    }
+
+    template <typename T>
+    uint64_t Serialize(SerializationWriter& dest, uint64_t& offset, const T& v, uint64_t alignment = 0)
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
         {
-            uint64_t elementSize = Serialize(dest, offset, e);
-            size += elementSize;
+            dest.Write(&v, sizeof(T));
+            offset += sizeof(T);
+            return sizeof(T);
+        }
+        else if constexpr (internal::IsStringViewV<T>)
+        {
+            uint64_t size = Serialize(dest, offset, uint64_t(v.size()));
+            dest.Write(v.data(), v.size());
+            offset += v.size();
+            return size + v.size();
+        }
+        else if constexpr (internal::IsSpanV<T>)
+        {
+            uint64_t size = Serialize(dest, offset, uint64_t(v.size()));
+            if constexpr (internal::IsBulkSerializableV<typename T::value_type>)
+            {
+                return size + SerializeArray(dest, offset, v, alignment);
+            }
+            else
+            {
+                uint64_t padding = AlignSize(offset, internal::SpanAlignment<typename T::value_type>(alignment)) - offset;
+                dest.WriteZeroes(padding);
+                offset += padding;
+                size += padding;
+
+                for (const auto& e : v)
+                {
+                    size += Serialize(dest, offset, e);
+                }
+                return size;
+            }
+        }
+        else if constexpr (internal::IsStructureOfArraysV<T>)
+        {
+            return T::Serialize(v, offset, dest, alignment);
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>);
+            return T::Serialize(v, offset, dest);
         }
-        return size;
     }
 
     template <typename T>
-    uint64_t Serialize(const Span<uint8_t> dest, const T& v)
+    uint64_t Serialize(SerializationWriter& dest, const T& v)
     {
         uint64_t offset = 0;
         return Serialize<T>(dest, offset, v);
@@ -146,6 +419,30 @@ namespace rn
         return out;
     }
 
+    // Returns the absolute offset of a field, read from the offset table of the struct starting at structOffset
+    inline uint64_t DeserializeFieldOffset(const Span<const uint8_t> src, uint64_t structOffset, uint32_t fieldIdx)
+    {
+        uint64_t tableOffset = structOffset + fieldIdx * SERIALIZED_FIELD_OFFSET_SIZE;
+        uint64_t fieldOffset = structOffset + DeserializeDirect<uint64_t>(src, tableOffset);
+
+        RN_ASSERT(fieldOffset <= src.size_bytes());
+        return fieldOffset;
+    }
+
+    template <typename T>
+    Span<T> DeserializeArray(const Span<const uint8_t> src, uint64_t& offset, uint64_t count, void*(*fnAlloc)(size_t), uint64_t alignment = 0)
+    {
+        static_assert(internal::IsBulkSerializableV<T>);
+        offset = AlignSize(offset, internal::SpanAlignment<T>(alignment));
+        RN_ASSERT(src.size_bytes() >= offset);
+        RN_ASSERT((src.size_bytes() - offset) / sizeof(T) >= count);
+
+        T* elements = static_cast<T*>(fnAlloc(sizeof(T) * count));
+        std::memcpy(elements, src.data() + offset, sizeof(T) * count);
+        offset += sizeof(T) * count;
+        return { elements, count };
+    }
+
     template <typename T>
     requires std::is_arithmetic_v<T> || std::is_enum_v<T>
     T Deserialize(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t))
@@ -154,7 +451,7 @@ namespace rn
     }
 
     template <typename T>
-    requires std::is_aggregate_v<T>
+    requires internal::IsSchemaStructV<T>
     T Deserialize(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t))
     {
         return T::Deserialize(src, offset, fnAlloc);
@@ -162,22 +459,39 @@ namespace rn
 
     template <typename T>
     requires internal::IsSpanV<T>
-    T Deserialize(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t))
+    T Deserialize(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t), uint64_t alignment = 0)
     {
+        using ValueType = typename T::value_type;
+
         // Load where we will find the span data, followed by the amount of elements
         uint64_t spanCount = DeserializeDirect<uint64_t>(src, offset);
+        if constexpr (internal::IsBulkSerializableV<ValueType>)
+        {
+            return DeserializeArray<ValueType>(src, offset, spanCount, fnAlloc, alignment);
+        }
+        else
+        {
+            offset = AlignSize(offset, internal::SpanAlignment<ValueType>(alignment));
+            RN_ASSERT(src.size_bytes() >= offset);
 
-        using ValueType = typename T::value_type;
-        ValueType* span = static_cast<ValueType*>(fnAlloc(sizeof(ValueType) * spanCount));
+            ValueType* span = static_cast<ValueType*>(fnAlloc(sizeof(ValueType) * spanCount));
 
-        // Deserialize elements/characters
-        for (uint64_t i = 0; i < spanCount; ++i)
-        {
-            new (&span[i]) ValueType;
-            span[i] = Deserialize<ValueType>(src, offset, fnAlloc);
+            // Deserialize elements/characters
+            for (uint64_t i = 0; i < spanCount; ++i)
+            {
+                new (&span[i]) ValueType;
+                span[i] = Deserialize<ValueType>(src, offset, fnAlloc);
+            }
+
+            return { span, spanCount };
         }
+    }
 
-        return { span, spanCount };
+    template <typename T>
+    requires internal::IsStructureOfArraysV<T>
+    T Deserialize(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t), uint64_t alignment = 0)
+    {
+        return T::Deserialize(src, offset, fnAlloc, alignment);
     }
 
     template <typename T>
@@ -200,4 +514,362 @@ namespace rn
         uint64_t offset = 0;
         return Deserialize<T>(src, offset, fnAlloc);
     }
+
+
+    // Views deserialize like Deserialize, except that strings and spans of bulk serializable types point into src rather than
+    // being copied out of it. Only spans of variable sized types allocate, for their element arrays. src needs to outlive the
+    // view and the view is read only, regardless of the span types it's made of.
+    template <typename T>
+    Span<T> DeserializeArrayView(const Span<const uint8_t> src, uint64_t& offset, uint64_t count, void*(*fnAlloc)(size_t), uint64_t alignment = 0)
+    {
+        static_assert(internal::IsBulkSerializableV<T>);
+        uint64_t arrayOffset = offset;
+        offset = AlignSize(offset, internal::SpanAlignment<T>(alignment));
+        RN_ASSERT(src.size_bytes() >= offset);
+        RN_ASSERT((src.size_bytes() - offset) / sizeof(T) >= count);
+
+        // Only happens for sources that aren't aligned to SERIALIZED_MAX_ALIGNMENT, in which case the elements get copied out
+        const uint8_t* elements = src.data() + offset;
+        if (count > 0 && reinterpret_cast<uintptr_t>(elements) % alignof(T) != 0)
+        {
+            offset = arrayOffset;
+            return DeserializeArray<T>(src, offset, count, fnAlloc, alignment);
+        }
+
+        offset += sizeof(T) * count;
+        return { const_cast<T*>(reinterpret_cast<const T*>(elements)), count };
+    }
+
+    template <typename T>
+    requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    T DeserializeView(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t))
+    {
+        return DeserializeDirect<T>(src, offset);
+    }
+
+    template <typename T>
+    requires internal::IsSchemaStructV<T>
+    T DeserializeView(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t))
+    {
+        return T::DeserializeView(src, offset, fnAlloc);
+    }
+
+    template <typename T>
+    requires internal::IsSpanV<T>
+    T DeserializeView(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t), uint64_t alignment = 0)
+    {
+        using ValueType = typename T::value_type;
+        uint64_t spanCount = DeserializeDirect<uint64_t>(src, offset);
+        if constexpr (internal::IsBulkSerializableV<ValueType>)
+        {
+            return DeserializeArrayView<ValueType>(src, offset, spanCount, fnAlloc, alignment);
+        }
+        else
+        {
+            offset = AlignSize(offset, internal::SpanAlignment<ValueType>(alignment));
+            RN_ASSERT(src.size_bytes() >= offset);
+
+            ValueType* span = static_cast<ValueType*>(fnAlloc(sizeof(ValueType) * spanCount));
+            for (uint64_t i = 0; i < spanCount; ++i)
+            {
+                new (&span[i]) ValueType;
+                span[i] = DeserializeView<ValueType>(src, offset, fnAlloc);
+            }
+
+            return { span, spanCount };
+        }
+    }
+
+    template <typename T>
+    requires internal::IsStructureOfArraysV<T>
+    T DeserializeView(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t), uint64_t alignment = 0)
+    {
+        return T::DeserializeView(src, offset, fnAlloc, alignment);
+    }
+
+    template <typename T>
+    requires internal::IsStringViewV<T>
+    T DeserializeView(const Span<const uint8_t> src, uint64_t& offset, void*(*fnAlloc)(size_t))
+    {
+        uint64_t strCount = DeserializeDirect<uint64_t>(src, offset);
+        RN_ASSERT(src.size_bytes() - offset >= strCount);
+
+        const char* str = reinterpret_cast<const char*>(src.data() + offset);
+        offset += strCount;
+
+        return { str, strCount };
+    }
+
+    template <typename T>
+    T DeserializeView(const Span<const uint8_t> src, void*(*fnAlloc)(size_t))
+    {
+        uint64_t offset = 0;
+        return DeserializeView<T>(src, offset, fnAlloc);
+    }
+
+    // Allocations carved out of a single one are aligned to this, the footprint accounts for it
+    constexpr const uint64_t DESERIALIZED_ALLOCATION_ALIGNMENT = alignof(std::max_align_t);
+
+    namespace internal
+    {
+        inline uint64_t FootprintOf(uint64_t allocationSize)
+        {
+            return AlignSize(allocationSize, DESERIALIZED_ALLOCATION_ALIGNMENT);
+        }
+
+        struct LinearAllocation
+        {
+            uint8_t* ptr = nullptr;
+            uint64_t remaining = 0;
+        };
+
+        // fnAlloc can't carry any state, so single allocation deserialization hands out a thread's current region instead
+        inline thread_local LinearAllocation t_linearAllocation;
+
+        inline void* LinearAlloc(size_t size)
+        {
+            uint64_t footprint = FootprintOf(size);
+            RN_ASSERT(t_linearAllocation.remaining >= footprint);
+
+            void* ptr = t_linearAllocation.ptr;
+            t_linearAllocation.ptr += footprint;
+            t_linearAllocation.remaining -= footprint;
+            return ptr;
+        }
+
+        struct ScopedLinearAllocation
+        {
+            ScopedLinearAllocation(void* ptr, uint64_t size)
+                : previous(t_linearAllocation)
+            {
+                t_linearAllocation = { static_cast<uint8_t*>(ptr), size };
+            }
+
+            ~ScopedLinearAllocation()
+            {
+                // The footprint pass has to account for every allocation exactly
+                RN_ASSERT(t_linearAllocation.remaining == 0);
+                t_linearAllocation = previous;
+            }
+
+            LinearAllocation previous;
+        };
+    }
+
+    // Bytes Deserialize, or DeserializeView when isView is set, would allocate for the data at offset, read from the
+    // serialized headers alone. Advances offset past the data like deserializing it would.
+    template <typename T>
+    uint64_t DeserializedArrayFootprint(const Span<const uint8_t> src, uint64_t& offset, uint64_t count, bool isView, uint64_t alignment = 0)
+    {
+        static_assert(internal::IsBulkSerializableV<T>);
+        offset = AlignSize(offset, internal::SpanAlignment<T>(alignment));
+        RN_ASSERT(src.size_bytes() >= offset);
+        RN_ASSERT((src.size_bytes() - offset) / sizeof(T) >= count);
+
+        // Views copy out misaligned elements, like DeserializeArrayView does
+        bool isCopied = !isView || (count > 0 && reinterpret_cast<uintptr_t>(src.data() + offset) % alignof(T) != 0);
+        offset += sizeof(T) * count;
+        return isCopied ? internal::FootprintOf(sizeof(T) * count) : 0;
+    }
+
+    template <typename T>
+    requires std::is_arithmetic_v<T> || std::is_enum_v<T>
+    uint64_t DeserializedFootprint(const Span<const uint8_t> src, uint64_t& offset, bool isView)
+    {
+        RN_ASSERT(src.size_bytes() - offset >= sizeof(T));
+        offset += sizeof(T);
+        return 0;
+    }
+
+    template <typename T>
+    requires internal::IsSchemaStructV<T>
+    uint64_t DeserializedFootprint(const Span<const uint8_t> src, uint64_t& offset, bool isView)
+    {
+        return T::DeserializedFootprint(src, offset, isView);
+    }
+
+    template <typename T>
+    requires internal::IsSpanV<T>
+    uint64_t DeserializedFootprint(const Span<const uint8_t> src, uint64_t& offset, bool isView, uint64_t alignment = 0)
+    {
+        using ValueType = typename T::value_type;
+        uint64_t spanCount = DeserializeDirect<uint64_t>(src, offset);
+        if constexpr (internal::IsBulkSerializableV<ValueType>)
+        {
+            return DeserializedArrayFootprint<ValueType>(src, offset, spanCount, isView, alignment);
+        }
+        else
+        {
+            offset = AlignSize(offset, internal::SpanAlignment<ValueType>(alignment));
+            RN_ASSERT(src.size_bytes() >= offset);
+
+            uint64_t footprint = internal::FootprintOf(sizeof(ValueType) * spanCount);
+            for (uint64_t i = 0; i < spanCount; ++i)
+            {
+                footprint += DeserializedFootprint<ValueType>(src, offset, isView);
+            }
+
+            return footprint;
+        }
+    }
+
+    template <typename T>
+    requires internal::IsStructureOfArraysV<T>
+    uint64_t DeserializedFootprint(const Span<const uint8_t> src, uint64_t& offset, bool isView, uint64_t alignment = 0)
+    {
+        return T::DeserializedFootprint(src, offset, isView, alignment);
+    }
+
+    template <typename T>
+    requires internal::IsStringViewV<T>
+    uint64_t DeserializedFootprint(const Span<const uint8_t> src, uint64_t& offset, bool isView)
+    {
+        uint64_t strCount = DeserializeDirect<uint64_t>(src, offset);
+        RN_ASSERT(src.size_bytes() - offset >= strCount);
+        offset += strCount;
+
+        return isView ? 0 : internal::FootprintOf(strCount);
+    }
+
+    // Deserializes with a single call to fnAlloc, sized by a footprint pass up front. Everything the result points to lives
+    // in that one allocation, which is returned through outAllocation for callers that need to free it.
+    template <typename T>
+    T DeserializeSingleAllocation(const Span<const uint8_t> src, void*(*fnAlloc)(size_t), void** outAllocation = nullptr)
+    {
+        uint64_t footprintOffset = 0;
+        uint64_t footprint = DeserializedFootprint<T>(src, footprintOffset, false);
+
+        void* allocation = footprint > 0 ? fnAlloc(footprint) : nullptr;
+        if (outAllocation)
+        {
+            *outAllocation = allocation;
+        }
+
+        internal::ScopedLinearAllocation SCOPE(allocation, footprint);
+        return Deserialize<T>(src, &internal::LinearAlloc);
+    }
+
+    template <typename T>
+    T DeserializeViewSingleAllocation(const Span<const uint8_t> src, void*(*fnAlloc)(size_t), void** outAllocation = nullptr)
+    {
+        uint64_t footprintOffset = 0;
+        uint64_t footprint = DeserializedFootprint<T>(src, footprintOffset, true);
+
+        void* allocation = footprint > 0 ? fnAlloc(footprint) : nullptr;
+        if (outAllocation)
+        {
+            *outAllocation = allocation;
+        }
+
+        internal::ScopedLinearAllocation SCOPE(allocation, footprint);
+        return DeserializeView<T>(src, &internal::LinearAlloc);
+    }
+
+    namespace internal
+    {
+        // MurmurHash3's finalizer
+        inline uint64_t MixHash(uint64_t h)
+        {
+            h ^= h >> 33;
+            h *= 0xFF51AFD7ED558CCD;
+            h ^= h >> 33;
+            h *= 0xC4CEB9FE1A85EC53;
+            h ^= h >> 33;
+            return h;
+        }
+
+        inline LargeHash CombineHash(const LargeHash& seed, uint64_t lower, uint64_t upper)
+        {
+            return {
+                .lower = MixHash(seed.lower ^ (MixHash(lower) + 0x9E3779B97F4A7C15 + (seed.lower << 6) + (seed.lower >> 2))),
+                .upper = MixHash(seed.upper ^ (MixHash(upper ^ lower) + 0x9E3779B97F4A7C15 + (seed.upper << 6) + (seed.upper >> 2)))
+            };
+        }
+
+        inline LargeHash CombineHash(const LargeHash& seed, const LargeHash& value)
+        {
+            return CombineHash(seed, value.lower, value.upper);
+        }
+    }
+
+    // Content hash of a schema object, walking its fields rather than serializing it first. Spans of bulk serializable types
+    // are hashed in one go. Values are hashed by their bits, matching Equals, and hashes are stable across runs and builds.
+    template <typename T>
+    LargeHash Hash(const T& v, const LargeHash& seed = {})
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &v, sizeof(T));
+            return internal::CombineHash(seed, bits, sizeof(T));
+        }
+        else if constexpr (internal::IsStringViewV<T>)
+        {
+            LargeHash hash = internal::CombineHash(seed, v.size(), 0);
+            return internal::CombineHash(hash, HashMemory(v.data(), v.size()));
+        }
+        else if constexpr (internal::IsSpanV<T>)
+        {
+            LargeHash hash = internal::CombineHash(seed, v.size(), 0);
+            if constexpr (internal::IsBulkSerializableV<typename T::value_type>)
+            {
+                return internal::CombineHash(hash, HashMemory(v.data(), v.size_bytes()));
+            }
+            else
+            {
+                for (const auto& e : v)
+                {
+                    hash = Hash(e, hash);
+                }
+                return hash;
+            }
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>);
+            return T::Hash(v, seed);
+        }
+    }
+
+    // Compares values by their bits, so 0.0f and -0.0f differ while NaNs equal themselves. That's what cache keys need.
+    template <typename T>
+    bool Equals(const T& lhs, const T& rhs)
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        {
+            return std::memcmp(&lhs, &rhs, sizeof(T)) == 0;
+        }
+        else if constexpr (internal::IsStringViewV<T>)
+        {
+            return lhs == rhs;
+        }
+        else if constexpr (internal::IsSpanV<T>)
+        {
+            if (lhs.size() != rhs.size())
+            {
+                return false;
+            }
+
+            if constexpr (internal::IsBulkSerializableV<typename T::value_type>)
+            {
+                return lhs.empty() || std::memcmp(lhs.data(), rhs.data(), lhs.size_bytes()) == 0;
+            }
+            else
+            {
+                for (size_t i = 0; i < lhs.size(); ++i)
+                {
+                    if (!Equals(lhs[i], rhs[i]))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+        }
+        else
+        {
+            static_assert(std::is_aggregate_v<T>);
+            return lhs == rhs;
+        }
+    }
 }
\ No newline at end of file
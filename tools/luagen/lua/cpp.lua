@@ -19,11 +19,14 @@ cpp.PrimitiveTypeNames = {
 cpp.SpanName = "rn::Span"
 cpp.StringName = "std::string_view"
 cpp.AdditionalHeaderLines = {
+    '#include "common/memory/hash.hpp"',
     '#include "common/memory/memory.hpp"',
     '#include "common/memory/span.hpp"',
     '#include "common/memory/string.hpp"'
 }
 cpp.AssertName = "RN_ASSERT"
+cpp.WriterName = "rn::SerializationWriter"
+cpp.SoASuffix = "SoA"
 
 function cpp:new(filename, typesToSerialize, namespace, importedFiles)
     o = o or {}
@@ -69,6 +72,10 @@ function cpp:beginHeader()
         w:writeLn("#include \"%s\"", path.getbasename(v) .. "_gen.hpp")
     end
 
+    w:lineBreak()
+    self:openScope("namespace rn")
+    w:writeLn("class SerializationWriter;")
+    self:closeScope()
     w:lineBreak()
     w:writeLn("using namespace std::literals;")
     w:lineBreak()
@@ -158,7 +165,11 @@ function cpp:resolveTypeName(typeToResolve)
         name = self.PrimitiveTypeNames[typeToResolve.primitive]
 
     elseif (typeToResolve.layout == Schema.TypeLayout.Span) then
-        name = self.SpanName .. "<" .. self:resolveTypeName(typeToResolve.spannedType) .. ">"
+        if typeToResolve.soa then
+            name = self:resolveTypeName(typeToResolve.spannedType) .. cpp.SoASuffix
+        else
+            name = self.SpanName .. "<" .. self:resolveTypeName(typeToResolve.spannedType) .. ">"
+        end
 
     else
         for _, v in ipairs(self.typesToSerialize) do
@@ -244,8 +255,23 @@ function cpp:writeStruct(name, type)
 
         -- Serialization
         w:writeLn("static %s Deserialize(const %s<const uint8_t>& data, uint64_t& offset, void*(*fnAlloc)(size_t));", name, cpp.SpanName)
-        w:writeLn("static uint64_t SerializedSize(const %s& data);", name)
+        w:writeLn("static %s DeserializeView(const %s<const uint8_t>& data, uint64_t& offset, void*(*fnAlloc)(size_t));", name, cpp.SpanName)
+        w:writeLn("static uint64_t DeserializedFootprint(const %s<const uint8_t>& data, uint64_t& offset, bool isView);", cpp.SpanName)
+        w:lineBreak()
+        w:writeLn("static rn::LargeHash Hash(const %s& data, const rn::LargeHash& seed = {});", name)
+        w:writeLn("friend bool operator==(const %s& lhs, const %s& rhs);", name, name)
+        w:writeLn("static uint64_t SerializedSize(const %s& data, uint64_t offset = 0);", name)
         w:writeLn("static uint64_t Serialize(const %s& data, uint64_t& offset, %s<uint8_t> out);", name, cpp.SpanName)
+        w:writeLn("static uint64_t Serialize(const %s& data, uint64_t& offset, %s& out);", name, cpp.WriterName)
+
+        -- Lets spans of types whose memory layout matches the serialized bytes get copied in one go
+        if type.fixedSerializedSize then
+            w:writeLn("static constexpr uint64_t FixedSerializedSize = %d;", type.fixedSerializedSize)
+        end
+
+        if type.offsetTable then
+            self:writeAccessorDeclaration(name, type)
+        end
         
         -- Decoration
         if type.decorations then
@@ -269,7 +295,50 @@ function cpp:writeStruct(name, type)
         end
         self:closeScope(";")
         w:lineBreak()
+
+        if type.soaView then
+            self:writeSoAView(name, type)
+        end
+    end
+end
+
+-- Spans of the struct marked soa() are read and written through this instead, one span per member
+function cpp:writeSoAView(elementName, type)
+    local w = self.writer
+    local name = elementName .. cpp.SoASuffix
+    local first = type.elements[1].name
+
+    self:openScope("struct %s", name)
+    w:writeLn("using ElementType = %s;", elementName)
+    w:lineBreak()
+
+    for _, v in ipairs(type.elements) do
+        w:writeLn("%s<%s> %s;", cpp.SpanName, self:resolveTypeName(v.type), v.name)
+    end
+    w:lineBreak()
+
+    w:writeLn("size_t size() const { return %s.size(); }", first)
+    w:writeLn("bool empty() const { return %s.empty(); }", first)
+    self:openScope("%s operator[](size_t idx) const", elementName)
+    self:openScope("return")
+    for _, v in ipairs(type.elements) do
+        w:writeLn(".%s = %s[idx],", v.name, v.name)
     end
+    self:closeScope(";")
+    self:closeScope()
+    w:lineBreak()
+
+    w:writeLn("static %s Deserialize(const %s<const uint8_t>& data, uint64_t& offset, void*(*fnAlloc)(size_t), uint64_t alignment = 0);", name, cpp.SpanName)
+    w:writeLn("static %s DeserializeView(const %s<const uint8_t>& data, uint64_t& offset, void*(*fnAlloc)(size_t), uint64_t alignment = 0);", name, cpp.SpanName)
+    w:writeLn("static uint64_t DeserializedFootprint(const %s<const uint8_t>& data, uint64_t& offset, bool isView, uint64_t alignment = 0);", cpp.SpanName)
+    w:lineBreak()
+    w:writeLn("static rn::LargeHash Hash(const %s& data, const rn::LargeHash& seed = {});", name)
+    w:writeLn("friend bool operator==(const %s& lhs, const %s& rhs);", name, name)
+    w:writeLn("static uint64_t SerializedSize(const %s& data, uint64_t offset = 0, uint64_t alignment = 0);", name)
+    w:writeLn("static uint64_t Serialize(const %s& data, uint64_t& offset, %s<uint8_t> out, uint64_t alignment = 0);", name, cpp.SpanName)
+    w:writeLn("static uint64_t Serialize(const %s& data, uint64_t& offset, %s& out, uint64_t alignment = 0);", name, cpp.WriterName)
+    self:closeScope(";")
+    w:lineBreak()
 end
 
 function cpp:beginCPP()
@@ -315,10 +384,28 @@ function cpp:writeCPP()
                 end
                 self:writeSerializedSizeDefinition(v.name, v.type)
                 w:lineBreak()
-                self:writeStructSerializeDefinition(v.name, v.type)
+                self:writeStructSerializeDefinition(v.name, v.type, cpp.SpanName .. "<uint8_t>")
+                w:lineBreak()
+                self:writeStructSerializeDefinition(v.name, v.type, cpp.WriterName .. "&")
                 w:lineBreak()
                 self:writeStructDeserializeDefinition(v.name, v.type)
                 w:lineBreak()
+                self:writeStructDeserializeViewDefinition(v.name, v.type)
+                w:lineBreak()
+                self:writeDeserializedFootprintDefinition(v.name, v.type)
+                w:lineBreak()
+                self:writeHashDefinition(v.name, v.type)
+                w:lineBreak()
+                self:writeEqualsDefinition(v.name, v.type)
+                w:lineBreak()
+
+                if v.type.offsetTable then
+                    self:writeAccessorDefinition(v.name, v.type)
+                end
+
+                if v.type.soaView then
+                    self:writeSoAViewDefinitions(v.name, v.type)
+                end
             end
         end
     end
@@ -326,31 +413,65 @@ function cpp:writeCPP()
     self:endCPP()
 end
 
+-- Fields without an alignment of their own leave it up to the runtime's defaults
+function cpp:alignmentArgument(field)
+    if field.align then
+        return string.format(", %d", field.align)
+    end
+
+    return ""
+end
+
 function cpp:writeSerializedSizeDefinition(name, type)
 
     local w = self.writer
-    self:openScope("uint64_t %s::SerializedSize(const %s& data)", name, name)
-    w:writeLn("uint64_t size = 0;")
+    self:openScope("uint64_t %s::SerializedSize(const %s& data, uint64_t offset)", name, name)
+    if type.fixedSerializedSize then
+        w:writeLn("return FixedSerializedSize;")
+        self:closeScope()
+        return
+    end
+
+    if type.offsetTable then
+        w:writeLn("uint64_t size = %d * rn::SERIALIZED_FIELD_OFFSET_SIZE;", #type.elements)
+    else
+        w:writeLn("uint64_t size = 0;")
+    end
     for _, v in ipairs(type.elements) do
-        w:writeLn("size += rn::SerializedSize(data.%s);", v.name)
+        w:writeLn("size += rn::SerializedSize(data.%s, offset + size%s);", v.name, self:alignmentArgument(v))
     end
     w:writeLn("return size;")
     self:closeScope()
 end
 
-function cpp:writeStructSerializeDefinition(name, type)
+-- Writes the same body for serializing into a buffer and into a SerializationWriter
+function cpp:writeStructSerializeDefinition(name, type, outTypeName)
     local w = self.writer
 
-    self:openScope("uint64_t %s::Serialize(const %s& data, uint64_t& offset, %s<uint8_t> out)", name, name, cpp.SpanName)
+    self:openScope("uint64_t %s::Serialize(const %s& data, uint64_t& offset, %s out)", name, name, outTypeName)
 
-    -- Determine write size
-    w:writeLn("uint64_t EXPECTED_SIZE = %s::SerializedSize(data);", name)
-    w:writeLn("%s(out.size_bytes() >= EXPECTED_SIZE);", cpp.AssertName, name)
-    w:lineBreak()
+    -- Sizing variable sized types would traverse them once per nesting level, every write checks its own bounds instead
+    if type.fixedSerializedSize and outTypeName ~= cpp.WriterName .. "&" then
+        w:writeLn("%s(out.size_bytes() >= offset + FixedSerializedSize);", cpp.AssertName)
+        w:lineBreak()
+    end
 
     w:writeLn("size_t size = 0;")
+
+    -- Offsets are worked out ahead of the fields, so streams never need to go back and patch the table
+    if type.offsetTable then
+        w:writeLn("const uint64_t structOffset = offset;")
+        w:writeLn("uint64_t fieldOffset = offset + %d * rn::SERIALIZED_FIELD_OFFSET_SIZE;", #type.elements)
+        for i, v in ipairs(type.elements) do
+            w:writeLn("size += rn::Serialize(out, offset, uint64_t(fieldOffset - structOffset));")
+            if i < #type.elements then
+                w:writeLn("fieldOffset += rn::SerializedSize(data.%s, fieldOffset%s);", v.name, self:alignmentArgument(v))
+            end
+        end
+    end
+
     for _, v in ipairs(type.elements) do
-        w:writeLn("size += rn::Serialize(out, offset, data.%s);", v.name, v.name)
+        w:writeLn("size += rn::Serialize(out, offset, data.%s%s);", v.name, self:alignmentArgument(v))
     end
 
     w:writeLn("return size;")
@@ -361,15 +482,193 @@ function cpp:writeStructDeserializeDefinition(name, type)
     local w = self.writer
 
     self:openScope("%s %s::Deserialize(const %s<const uint8_t>& data, uint64_t& offset, void*(*fnAlloc)(size_t))", name, name, cpp.SpanName)
+    self:writeSkipOffsetTable(type)
 
     self:openScope("return", name)
     for _, v in ipairs(type.elements) do
         local typeName = self:resolveTypeName(v.type)
-        w:writeLn(".%s = rn::Deserialize<%s>(data, offset, fnAlloc),", v.name, typeName, v.name)
+        w:writeLn(".%s = rn::Deserialize<%s>(data, offset, fnAlloc%s),", v.name, typeName, self:alignmentArgument(v))
     end
     self:closeScope(";")
 
     self:closeScope()
 end
 
+function cpp:writeStructDeserializeViewDefinition(name, type)
+    local w = self.writer
+
+    self:openScope("%s %s::DeserializeView(const %s<const uint8_t>& data, uint64_t& offset, void*(*fnAlloc)(size_t))", name, name, cpp.SpanName)
+    self:writeSkipOffsetTable(type)
+
+    self:openScope("return", name)
+    for _, v in ipairs(type.elements) do
+        local typeName = self:resolveTypeName(v.type)
+        w:writeLn(".%s = rn::DeserializeView<%s>(data, offset, fnAlloc%s),", v.name, typeName, self:alignmentArgument(v))
+    end
+    self:closeScope(";")
+
+    self:closeScope()
+end
+
+function cpp:writeDeserializedFootprintDefinition(name, type)
+    local w = self.writer
+
+    self:openScope("uint64_t %s::DeserializedFootprint(const %s<const uint8_t>& data, uint64_t& offset, bool isView)", name, cpp.SpanName)
+    self:writeSkipOffsetTable(type)
+
+    w:writeLn("uint64_t footprint = 0;")
+    for _, v in ipairs(type.elements) do
+        local typeName = self:resolveTypeName(v.type)
+        w:writeLn("footprint += rn::DeserializedFootprint<%s>(data, offset, isView%s);", typeName, self:alignmentArgument(v))
+    end
+    w:writeLn("return footprint;")
+
+    self:closeScope()
+end
+
+function cpp:writeHashDefinition(name, type)
+    local w = self.writer
+
+    self:openScope("rn::LargeHash %s::Hash(const %s& data, const rn::LargeHash& seed)", name, name)
+    w:writeLn("rn::LargeHash hash = seed;")
+    for _, v in ipairs(type.elements) do
+        w:writeLn("hash = rn::Hash(data.%s, hash);", v.name)
+    end
+    w:writeLn("return hash;")
+    self:closeScope()
+end
+
+function cpp:writeEqualsDefinition(name, type)
+    local w = self.writer
+
+    self:openScope("bool operator==(const %s& lhs, const %s& rhs)", name, name)
+    if #type.elements == 0 then
+        w:writeLn("return true;")
+    else
+        w:writeLn("return")
+        w:indent()
+        for i, v in ipairs(type.elements) do
+            local separator = i < #type.elements and " &&" or ";"
+            w:writeLn("rn::Equals(lhs.%s, rhs.%s)%s", v.name, v.name, separator)
+        end
+        w:unindent()
+    end
+    self:closeScope()
+end
+
+-- Views store their element count once, followed by an aligned array per member
+function cpp:writeSoAViewDefinitions(elementName, type)
+    local w = self.writer
+    local name = elementName .. cpp.SoASuffix
+
+    self:openScope("uint64_t %s::SerializedSize(const %s& data, uint64_t offset, uint64_t alignment)", name, name)
+    w:writeLn("uint64_t size = rn::SERIALIZED_SPAN_SIZE;")
+    for _, v in ipairs(type.elements) do
+        w:writeLn("size += rn::SerializedArraySize<%s>(data.size(), offset + size, alignment);", self:resolveTypeName(v.type))
+    end
+    w:writeLn("return size;")
+    self:closeScope()
+    w:lineBreak()
+
+    for _, outTypeName in ipairs({ cpp.SpanName .. "<uint8_t>", cpp.WriterName .. "&" }) do
+        self:openScope("uint64_t %s::Serialize(const %s& data, uint64_t& offset, %s out, uint64_t alignment)", name, name, outTypeName)
+        for i, v in ipairs(type.elements) do
+            if i > 1 then
+                w:writeLn("%s(data.%s.size() == data.size());", cpp.AssertName, v.name)
+            end
+        end
+        w:lineBreak()
+        w:writeLn("uint64_t size = rn::Serialize(out, offset, uint64_t(data.size()));")
+        for _, v in ipairs(type.elements) do
+            w:writeLn("size += rn::SerializeArray(out, offset, data.%s, alignment);", v.name)
+        end
+        w:writeLn("return size;")
+        self:closeScope()
+        w:lineBreak()
+    end
+
+    for _, deserializeName in ipairs({ "Deserialize", "DeserializeView" }) do
+        local arrayFunction = deserializeName == "Deserialize" and "DeserializeArray" or "DeserializeArrayView"
+        self:openScope("%s %s::%s(const %s<const uint8_t>& data, uint64_t& offset, void*(*fnAlloc)(size_t), uint64_t alignment)", name, name, deserializeName, cpp.SpanName)
+        w:writeLn("uint64_t count = rn::DeserializeDirect<uint64_t>(data, offset);")
+        self:openScope("return")
+        for _, v in ipairs(type.elements) do
+            w:writeLn(".%s = rn::%s<%s>(data, offset, count, fnAlloc, alignment),", v.name, arrayFunction, self:resolveTypeName(v.type))
+        end
+        self:closeScope(";")
+        self:closeScope()
+        w:lineBreak()
+    end
+
+    self:openScope("uint64_t %s::DeserializedFootprint(const %s<const uint8_t>& data, uint64_t& offset, bool isView, uint64_t alignment)", name, cpp.SpanName)
+    w:writeLn("uint64_t count = rn::DeserializeDirect<uint64_t>(data, offset);")
+    w:writeLn("uint64_t footprint = 0;")
+    for _, v in ipairs(type.elements) do
+        w:writeLn("footprint += rn::DeserializedArrayFootprint<%s>(data, offset, count, isView, alignment);", self:resolveTypeName(v.type))
+    end
+    w:writeLn("return footprint;")
+    self:closeScope()
+    w:lineBreak()
+
+    -- Member spans hash and compare like any other span, which is what the generated struct functions do with fields
+    self:writeHashDefinition(name, type)
+    w:lineBreak()
+    self:writeEqualsDefinition(name, type)
+    w:lineBreak()
+end
+
+-- Fields are stored in order, sequential reads don't need the offset table
+function cpp:writeSkipOffsetTable(type)
+    local w = self.writer
+    if type.offsetTable then
+        w:writeLn("%s(data.size_bytes() - offset >= %d * rn::SERIALIZED_FIELD_OFFSET_SIZE);", cpp.AssertName, #type.elements)
+        w:writeLn("offset += %d * rn::SERIALIZED_FIELD_OFFSET_SIZE;", #type.elements)
+        w:lineBreak()
+    end
+end
+
+function cpp:writeAccessorDeclaration(name, type)
+    local w = self.writer
+
+    -- Reads single fields as views through the offset table. Allocations are only needed for spans of variable sized types.
+    w:lineBreak()
+    self:openScope("class Accessor")
+    w:unindent()
+    w:writeLn("public:")
+    w:indent()
+    w:writeLn("Accessor(const %s<const uint8_t>& data, uint64_t offset = 0);", cpp.SpanName)
+    w:lineBreak()
+    for _, v in ipairs(type.elements) do
+        w:writeLn("%s %s(void*(*fnAlloc)(size_t) = nullptr) const;", self:resolveTypeName(v.type), v.name)
+    end
+    w:lineBreak()
+    w:unindent()
+    w:writeLn("private:")
+    w:indent()
+    w:writeLn("%s<const uint8_t> _data;", cpp.SpanName)
+    w:writeLn("uint64_t _offset;")
+    self:closeScope(";")
+end
+
+function cpp:writeAccessorDefinition(name, type)
+    local w = self.writer
+
+    w:writeLn("%s::Accessor::Accessor(const %s<const uint8_t>& data, uint64_t offset)", name, cpp.SpanName)
+    w:indent()
+    w:writeLn(": _data(data)")
+    w:writeLn(", _offset(offset)")
+    w:unindent()
+    w:writeLn("{}")
+    w:lineBreak()
+
+    for i, v in ipairs(type.elements) do
+        local typeName = self:resolveTypeName(v.type)
+        self:openScope("%s %s::Accessor::%s(void*(*fnAlloc)(size_t)) const", typeName, name, v.name)
+        w:writeLn("uint64_t offset = rn::DeserializeFieldOffset(_data, _offset, %d);", i - 1)
+        w:writeLn("return rn::DeserializeView<%s>(_data, offset, fnAlloc%s);", typeName, self:alignmentArgument(v))
+        self:closeScope()
+        w:lineBreak()
+    end
+end
+
 return cpp
\ No newline at end of file
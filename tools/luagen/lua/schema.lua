@@ -12,6 +12,10 @@ Schema.SpanByteSize = 16
 Schema.StringByteSize = 16
 Schema.EnumByteSize = 4
 
+-- Matches SERIALIZED_MAX_ALIGNMENT and SERIALIZED_FIELD_OFFSET_SIZE in luagen/schema.hpp
+Schema.MaxAlignment = 512
+Schema.FieldOffsetByteSize = 8
+
 Schema.PrimitiveType = {
     Uint8 =     1,
     Uint16 =    2,
@@ -76,6 +80,23 @@ local makestring = function(env)
     return ret
 end
 
+-- Serialized size of types without spans or strings, nil for variable sized types
+local fixedSerializedSize = function(fields)
+    local size = 0
+    for _, f in ipairs(fields) do
+        local fieldType = f.type
+        if fieldType.layout == Schema.TypeLayout.Primitive or fieldType.layout == Schema.TypeLayout.Enum then
+            size = size + fieldType.sizeInBytes
+        elseif fieldType.layout == Schema.TypeLayout.Struct and fieldType.fixedSerializedSize then
+            size = size + fieldType.fixedSerializedSize
+        else
+            return nil
+        end
+    end
+
+    return size
+end
+
 local validateValueAgainstSchema = function(schemaType, value, recursion)
 
     if schemaType.layout == Schema.TypeLayout.Primitive then
@@ -203,6 +224,28 @@ Schema.makeEnvAPI = function(env)
         }
     end
 
+    -- Stores the span as one contiguous array per struct member, read and written through a generated <Struct>SoA view.
+    -- The view is generated next to the struct, so the struct needs to be declared in the same schema.
+    local _soa = function(_env, spanType)
+        assert(spanType and spanType.layout == Schema.TypeLayout.Span, "Invalid span provided to soa")
+        local structType = spanType.spannedType
+        assert(structType.layout == Schema.TypeLayout.Struct, "Structure-of-arrays spans need to span a struct")
+        assert(#structType.elements > 0, "Structure-of-arrays spans need to span a struct with fields")
+        for _, f in ipairs(structType.elements) do
+            assert( f.type.layout == Schema.TypeLayout.Primitive or
+                    f.type.layout == Schema.TypeLayout.Enum,
+                    "Structure-of-arrays members need to be primitives or enums")
+        end
+
+        structType.soaView = true
+        return {
+            layout = Schema.TypeLayout.Span,
+            sizeInBytes = Schema.SpanByteSize,
+            spannedType = structType,
+            soa = true
+        }
+    end
+
     local _value = function(_env, name, val)
         assert(name and string.len(name) > 0, "Invalid name provided for enum value")
         assert(not val or type(val) == "number", "Enum value needs to be a number")
@@ -237,12 +280,22 @@ Schema.makeEnvAPI = function(env)
         return ret
     end
 
-    local _field = function(_env, fieldType, name)
+    local _field = function(_env, fieldType, name, attributes)
         assert(string.len(name) > 0, "Invalid name provided for enum value")
         assert(fieldType, "Invalid type provided to struct field")
+
+        -- Aligns the elements of a span relative to the start of the serialized data
+        local align = attributes and attributes.align
+        if align then
+            assert(fieldType.layout == Schema.TypeLayout.Span, "Only span fields can be aligned")
+            assert(type(align) == "number" and align > 0 and align & (align - 1) == 0, "Field alignment needs to be a power of two")
+            assert(align <= Schema.MaxAlignment, "Field alignment can't exceed " .. Schema.MaxAlignment)
+        end
+
         return {
             type = fieldType,
-            name = name
+            name = name,
+            align = align
         }
     end
 
@@ -259,6 +312,7 @@ Schema.makeEnvAPI = function(env)
             sizeInBytes = math.max(4, sizeInBytes),
             elements = fields,
             namespace = _env._currentNamespace,
+            fixedSerializedSize = fixedSerializedSize(fields),
         }
 
         table.insert(_env._orderedTypes, ret)
@@ -277,6 +331,7 @@ Schema.makeEnvAPI = function(env)
             sizeInBytes = math.max(4, sizeInBytes),
             elements = fields,
             namespace = _env._currentNamespace,
+            fixedSerializedSize = fixedSerializedSize(fields),
             external = true
         }
 
@@ -284,6 +339,17 @@ Schema.makeEnvAPI = function(env)
         return ret
     end
 
+    -- Prefixes the struct with the offset of every field, so single fields can be read without deserializing the others
+    local _offset_table = function(_env, type)
+        assert(type and type.layout == Schema.TypeLayout.Struct, "Offset tables can only be added to structs")
+        type.offsetTable = true
+        if type.fixedSerializedSize then
+            type.fixedSerializedSize = type.fixedSerializedSize + #type.elements * Schema.FieldOffsetByteSize
+        end
+
+        return type
+    end
+
     local _decorate = function(_env, type, decorations)
         assert(type, "Invalid type provided to decorate")
         assert(decorations, "No decorations provided to decorate")
@@ -314,11 +380,13 @@ Schema.makeEnvAPI = function(env)
     env.namespace =     function(str)                   return _namespace(env, str) end
     env.value =         function(name, val)             return _value(env, name, val) end
     env.span =          function(spannedType)           return _span(env, spannedType) end
+    env.soa =           function(spanType)              return _soa(env, spanType) end
     env.enum =          function(values)                return _enum(env, values) end
     env.fwd_enum =      function()                      return _fwd_enum(env) end
-    env.field =         function(fieldType, name)       return _field(env, fieldType, name) end
+    env.field =         function(fieldType, name, attr) return _field(env, fieldType, name, attr) end
     env.struct =        function(fields)                return _struct(env, fields) end
     env.fwd_struct =    function(fields)                return _fwd_struct(env, fields) end
+    env.offset_table =  function(type)                  return _offset_table(env, type) end
     env.decorate =      function(type, decorations)     return _decorate(env, type, decorations) end
     env.decoration =    function(type, name, value)     return _decoration(env, type, name, value) end
 end